@@ -34,6 +34,10 @@
 #define LEPFLIR_GEN_CMD_TIMEOUT         5000        // Timeout for commands to be processed
 #define LEPFLIR_SPI_MAX_SPEED           20000000    // Maximum SPI speed for FLiR module
 #define LEPFLIR_SPI_MIN_SPEED           2200000     // Minimum SPI speed for FLiR module
+#define LEPFLIR_SPI_FRAME_WAIT_TIMEOUT  250         // Timeout for next frame to begin while streaming
+#define LEPFLIR_SPI_MAX_SEGMENT_SKIPS   32          // Maximum Lepton 3.x segments discarded during frame read
+#define LEPFLIR_SPI_MAX_DUPLICATE_SKIPS 5           // Maximum duplicate frames skipped during frame read
+#define LEPFLIR_SOFT_AGC_BINS           256         // Software AGC histogram bins (and LUT entries)
 #define LEPFLIR_SPI_FRAME_PACKET_SIZE           164 // 2B ID + 2B CRC + 160B for 80x1 14bpp/8bppAGC thermal image data or telemetry data
 #define LEPFLIR_SPI_FRAME_PACKET_SIZE16         82
 
@@ -49,6 +53,14 @@ static inline byte *roundUpMalloc16(int size) { return (byte *)malloc((size_t)si
 static inline byte *roundUpSpiFrame16(byte *spiFrame) { return spiFrame; }
 #endif
 
+// Carves size bytes (aligned) out of a memory arena, or NULL if they do not fit
+static inline byte *roundUpCarve16(byte **arenaData, byte *arenaEnd, int size) {
+    byte *data = roundUpPtr16(*arenaData);
+    if (!data || data + size > arenaEnd) return NULL;
+    *arenaData = data + size;
+    return data;
+}
+
 #ifndef digitalWriteFast
 static void csEnableFuncDef(byte pin) { digitalWrite(pin, LOW); }
 static void csDisableFuncDef(byte pin) { digitalWrite(pin, HIGH); }
@@ -57,6 +69,8 @@ static void csEnableFuncDef(byte pin) { digitalWriteFast(pin, LOW); }
 static void csDisableFuncDef(byte pin) { digitalWriteFast(pin, HIGH); }
 #endif
 
+static LeptonFLiRSPITransport _defaultTransport;
+
 #ifndef LEPFLIR_USE_SOFTWARE_I2C
 LeptonFLiR::LeptonFLiR(TwoWire& i2cWire, byte spiCSPin) {
     _i2cWire = &i2cWire;
@@ -68,15 +82,66 @@ LeptonFLiR::LeptonFLiR(byte spiCSPin) {
     _storageMode = LeptonFLiR_ImageStorageMode_Count;
     _csEnableFunc = csEnableFuncDef;
     _csDisableFunc = csDisableFuncDef;
-    _imageData = _spiFrameData = _telemetryData = NULL;
+    _imageData = _imageRowData = _spiFrameData = _telemetryData = NULL;
+    _memoryArena = NULL;
+    _memoryArenaBytes = 0;
+    _imageRowFunc = NULL;
+    _telemetryPacketFunc = NULL;
+    _imageBuffers[0] = _imageBuffers[1] = _imageBuffers[2] = NULL;
+    _frameBufferCount = 1;
+    _frontBuffer = _backBuffer = 0;
+    _frameNumbers[0] = _frameNumbers[1] = _frameNumbers[2] = 0;
+    _framesRead = 0;
+    _transport = &_defaultTransport;
     _isReadingNextFrame = false;
+    _captureStateValid = false;
+    _agcEnabled = _telemetryEnabled = false;
+    _heqScaleFactor = LEP_AGC_SCALE_TO_8_BITS;
+    _telemetryLocation = LEP_TELEMETRY_LOCATION_FOOTER;
+    _tlinearResolution = LEP_RAD_RESOLUTION_0_01;
+    _shadowCache = NULL;
+    _shadowCacheEnabled = false;
+    _shadowCacheInterval = 1000;
+    _cmdQueueHead = _cmdQueueTail = NULL;
+    _cmdQueueEndTime = 0;
+    _cmdPollMinMicros = 25;
+    _cmdPollMaxMicros = 1000;
+    _cmdBeginMicros = 0;
+    resetCommandStats();
+    _shadowCacheMillis = 0;
+    _commandCount = 0;
+    _commandCountValid = false;
+    _streamingEnabled = _streamInSync = false;
+    _streamSyncedFrames = 0;
+    _packetCRCEnabled = false;
+    _frameCRCErrors = 0;
+    _totalCRCErrors = 0;
+    _uniqueFramesOnly = _lastFrameCounterValid = false;
+    _lastFrameCounter = 0;
+    _duplicateFramesSkipped = 0;
+    _frameStatsEnabled = false;
+    _frameStatsThreshold = 0xFFFF;
+    memset(_frameStats, 0, sizeof(_frameStats));
+    _softAGCData = NULL;
+    _softAGCEnabled = false;
+    _softAGCPolicy = LEP_AGC_HEQ;
+    _softAGCRegion.startCol = _softAGCRegion.startRow = 0;
+    _softAGCRegion.endCol = 159; _softAGCRegion.endRow = 119;
+    _softAGCClipLimitHigh = 4800;
+    _softAGCClipLimitLow = 512;
+    _softAGCHistMin = _softAGCLutMin = 0;
+    _softAGCHistShift = _softAGCLutShift = 6;
     _lastI2CError = _lastLepResult = 0;
 }
 
 LeptonFLiR::~LeptonFLiR() {
+    if (_memoryArena) return;
+    if (_shadowCache) free(_shadowCache);
     if (_imageData) free(_imageData);
+    if (_imageRowData) free(_imageRowData);
     if (_spiFrameData) free(_spiFrameData);
     if (_telemetryData) free(_telemetryData);
+    if (_softAGCData) free(_softAGCData);
 }
 
 void LeptonFLiR::init(LeptonFLiR_ImageStorageMode storageMode, LeptonFLiR_TemperatureMode tempMode) {
@@ -95,30 +160,75 @@ void LeptonFLiR::init(LeptonFLiR_ImageStorageMode storageMode, LeptonFLiR_Temper
     pinMode(_spiCSPin, OUTPUT);
     _csDisableFunc(_spiCSPin);
 
-    _imageData = roundUpMalloc16(getImageTotalBytes());
+    // Memory arena starts with the telemetry data storage reserved by allocTelemetryData
+    byte *arenaData = _memoryArena, *arenaEnd = _memoryArena + _memoryArenaBytes;
+    if (_memoryArena)
+        roundUpCarve16(&arenaData, arenaEnd, roundUpVal16(_frameBufferCount * LEPFLIR_SPI_FRAME_PACKET_SIZE));
+
+    if (!_imageRowFunc)
+        _imageData = (_memoryArena ? roundUpCarve16(&arenaData, arenaEnd, getImageBuffersTotalBytes()) : roundUpMalloc16(getImageBuffersTotalBytes()));
+    else
+        _imageRowData = (_memoryArena ? roundUpCarve16(&arenaData, arenaEnd, getImageBuffersTotalBytes()) : roundUpMalloc16(getImageBuffersTotalBytes()));
+    for (int buffer = 0; buffer < _frameBufferCount; ++buffer)
+        _imageBuffers[buffer] = _imageData ? roundUpPtr16(_imageData) + (buffer * roundUpVal16(getImageTotalBytes())) : NULL;
+    _frontBuffer = 0;
+    _backBuffer = (_frameBufferCount > 1 ? 1 : 0);
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-    if (!_imageData)
+    if (!_imageData && !_imageRowData)
         Serial.println("  LeptonFLiR::init Failure allocating imageData.");
 #endif
 
-    _spiFrameData = roundUpMalloc16(getSPIFrameTotalBytes());
+    _spiFrameData = (_memoryArena ? roundUpCarve16(&arenaData, arenaEnd, getSPIFrameTotalBytes()) : roundUpMalloc16(getSPIFrameTotalBytes()));
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     if (!_spiFrameData)
         Serial.println("  LeptonFLiR::init Failure allocating spiFrameData.");
 #endif
 
+    if (_softAGCEnabled) {
+        _softAGCData = (_memoryArena ? roundUpCarve16(&arenaData, arenaEnd, LEPFLIR_SOFT_AGC_BINS * 3) : roundUpMalloc16(LEPFLIR_SOFT_AGC_BINS * 3));
+        if (_softAGCData) {
+            byte *lutData = getSoftAGCLUT(); // initially same as dividing 14bpp data down
+            for (int bin = 0; bin < LEPFLIR_SOFT_AGC_BINS; ++bin)
+                lutData[bin] = (byte)bin;
+        }
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        if (!_softAGCData)
+            Serial.println("  LeptonFLiR::init Failure allocating softAGCData.");
+#endif
+    }
+
+    if (_shadowCacheEnabled && _memoryArena) {
+        _shadowCache = (LeptonConfigProfile *)roundUpCarve16(&arenaData, arenaEnd, sizeof(LeptonConfigProfile));
+        invalidateShadowCache();
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        if (!_shadowCache)
+            Serial.println("  LeptonFLiR::init Failure allocating shadowCache.");
+#endif
+    }
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     int mallocOffset = 0;
 #ifndef LEPFLIR_DISABLE_ALIGNED_MALLOC
     mallocOffset = 15;
 #endif
     Serial.print("  LeptonFLiR::init imageData: ");
-    Serial.print(_imageData ? getImageTotalBytes() + mallocOffset : 0);
+    Serial.print(_imageData || _imageRowData ? getImageBuffersTotalBytes() + mallocOffset : 0);
     Serial.print("B, spiFrameData: ");
     Serial.print(_spiFrameData ? getSPIFrameTotalBytes() + mallocOffset : 0);
     Serial.print("B, total: ");
-    Serial.print((_imageData ? getImageTotalBytes() + mallocOffset : 0) + (_spiFrameData ? getSPIFrameTotalBytes() + mallocOffset : 0));
+    Serial.print((_imageData || _imageRowData ? getImageBuffersTotalBytes() + mallocOffset : 0) + (_spiFrameData ? getSPIFrameTotalBytes() + mallocOffset : 0));
     Serial.println("B");
+    if (_frameBufferCount > 1) {
+        Serial.print("  LeptonFLiR::init frameBufferCount: ");
+        Serial.println(_frameBufferCount);
+    }
+    if (_memoryArena) {
+        Serial.print("  LeptonFLiR::init memoryArena: ");
+        Serial.print((int)(arenaData - _memoryArena));
+        Serial.print("B used of ");
+        Serial.print(_memoryArenaBytes);
+        Serial.println("B");
+    }
     Serial.print("  LeptonFLiR::init SPIPortSpeed: ");
     for (int divisor = 2; divisor <= 128; divisor *= 2) {
         if (F_CPU / (float)divisor <= LEPFLIR_SPI_MAX_SPEED + 0.00001f || divisor == 128) {
@@ -155,6 +265,502 @@ void LeptonFLiR::setFastCSFuncs(digitalWriteFunc csEnableFunc, digitalWriteFunc
     _csDisableFunc = csDisableFunc ? : csDisableFuncDef;
 }
 
+void LeptonFLiR::setImageRowCallback(imageRowFunc rowFunc) {
+    if (_imageData || _imageRowData) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::setImageRowCallback Image row callback must be set before init. Ignoring.");
+#endif
+        return;
+    }
+
+    _imageRowFunc = rowFunc;
+}
+
+void LeptonFLiR::setTelemetryPacketCallback(telemetryPacketFunc packetFunc) {
+    _telemetryPacketFunc = packetFunc;
+}
+
+void LeptonFLiR::setStreamingEnabled(bool enabled) {
+    _streamingEnabled = enabled;
+    _streamInSync = false;
+    _streamSyncedFrames = 0;
+}
+
+bool LeptonFLiR::getStreamingEnabled() {
+    return _streamingEnabled;
+}
+
+uint32_t LeptonFLiR::getStreamingSyncedFrames() {
+    return _streamSyncedFrames;
+}
+
+void LeptonFLiR::setUniqueFramesOnly(bool enabled) {
+    _uniqueFramesOnly = enabled;
+}
+
+bool LeptonFLiR::getUniqueFramesOnly() {
+    return _uniqueFramesOnly;
+}
+
+void LeptonFLiR::setFrameStatsEnabled(bool enabled, uint16_t threshold) {
+    _frameStatsEnabled = enabled;
+    _frameStatsThreshold = threshold;
+}
+
+bool LeptonFLiR::getFrameStatsEnabled() {
+    return _frameStatsEnabled;
+}
+
+void LeptonFLiR::getFrameStats(FrameStats *stats) {
+    if ((_isReadingNextFrame && _frameBufferCount == 1) || !stats) return;
+    memcpy(stats, &_frameStats[_frontBuffer], sizeof(FrameStats));
+}
+
+void LeptonFLiR::setSoftAGCEnabled(bool enabled) {
+    if (enabled && !_softAGCData && (_imageData || _imageRowData)) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::setSoftAGCEnabled Software AGC must first be enabled before init. Ignoring.");
+#endif
+        return;
+    }
+
+    _softAGCEnabled = enabled;
+}
+
+bool LeptonFLiR::getSoftAGCEnabled() {
+    return _softAGCEnabled;
+}
+
+void LeptonFLiR::setSoftAGCPolicy(LEP_AGC_POLICY policy) {
+    _softAGCPolicy = policy;
+}
+
+LEP_AGC_POLICY LeptonFLiR::getSoftAGCPolicy() {
+    return _softAGCPolicy;
+}
+
+void LeptonFLiR::setSoftAGCHistogramRegion(LEP_AGC_HISTOGRAM_ROI *region) {
+    if (!region) return;
+    _softAGCRegion = *region;
+}
+
+void LeptonFLiR::getSoftAGCHistogramRegion(LEP_AGC_HISTOGRAM_ROI *region) {
+    if (!region) return;
+    *region = _softAGCRegion;
+}
+
+void LeptonFLiR::setSoftAGCHEQClipLimits(uint16_t limitHigh, uint16_t limitLow) {
+    _softAGCClipLimitHigh = limitHigh;
+    _softAGCClipLimitLow = limitLow;
+}
+
+byte *LeptonFLiR::getSoftAGCLUT() {
+    return _softAGCData ? roundUpPtr16(_softAGCData) + (LEPFLIR_SOFT_AGC_BINS * 2) : NULL;
+}
+
+static inline uint_fast8_t softAGCBin(uint16_t value, uint16_t binMin, uint_fast8_t binShift) {
+    uint16_t bin = (value > binMin ? (value - binMin) >> binShift : 0);
+    return (uint_fast8_t)(bin < LEPFLIR_SOFT_AGC_BINS ? bin : LEPFLIR_SOFT_AGC_BINS - 1);
+}
+
+byte LeptonFLiR::getSoftAGCValue(uint16_t value) {
+    byte *lutData = getSoftAGCLUT();
+    return lutData ? lutData[softAGCBin(value, _softAGCLutMin, _softAGCLutShift)] : (byte)(value >> 6);
+}
+
+void LeptonFLiR::resetSoftAGCHistogram() {
+    memset(roundUpPtr16(_softAGCData), 0, LEPFLIR_SOFT_AGC_BINS * 2);
+    _frameRead.agcMin = 0xFFFF;
+    _frameRead.agcMax = 0;
+}
+
+// Adds a packet's worth of 14bpp image data to the software AGC histogram (over the part of
+// it inside the histogram region), and when given 8bpp image data, maps it through the LUT.
+void LeptonFLiR::softAGCPacket(uint16_t *valueData, byte *pxlData, uint_fast8_t imgCol, uint_fast8_t imgCols) {
+    FrameReadState &fr = _frameRead;
+    uint16_t *histData = (uint16_t *)roundUpPtr16(_softAGCData);
+
+    if (fr.currImgRow >= fr.agcRowBegin && fr.currImgRow <= fr.agcRowEnd && fr.agcColEnd >= imgCol && fr.agcColBegin < imgCol + imgCols) {
+        uint_fast8_t col = (fr.agcColBegin > imgCol ? fr.agcColBegin - imgCol : 0);
+        uint_fast8_t colEnd = (fr.agcColEnd - imgCol + 1 < imgCols ? fr.agcColEnd - imgCol + 1 : imgCols);
+        uint16_t histMin = _softAGCHistMin;
+        uint_fast8_t histShift = _softAGCHistShift;
+
+        for (; col < colEnd; ++col) {
+            uint16_t value = valueData[col];
+            if (value < fr.agcMin) fr.agcMin = value;
+            if (value > fr.agcMax) fr.agcMax = value;
+            ++histData[softAGCBin(value, histMin, histShift)];
+        }
+    }
+
+    if (pxlData) {
+        byte *lutData = (byte *)(histData + LEPFLIR_SOFT_AGC_BINS);
+        uint16_t lutMin = _softAGCLutMin;
+        uint_fast8_t lutShift = _softAGCLutShift;
+
+        while (imgCols--)
+            *pxlData++ = lutData[softAGCBin(*valueData++, lutMin, lutShift)];
+    }
+}
+
+// Makes the software AGC LUT out of the histogram of the frame just read, then has the
+// histogram of the next frame span the range of values found in this one.
+void LeptonFLiR::updateSoftAGCLUT() {
+    FrameReadState &fr = _frameRead;
+    uint16_t *histData = (uint16_t *)roundUpPtr16(_softAGCData);
+    byte *lutData = (byte *)(histData + LEPFLIR_SOFT_AGC_BINS);
+
+    if (fr.agcMin > fr.agcMax) return; // empty histogram region
+
+    if (_softAGCPolicy == LEP_AGC_HEQ) {
+        // Clip limits are given in module pixels, scaled down to image pixels
+        uint32_t modulePixels = 4800UL * fr.spiHalves * fr.spiHalves;
+        uint32_t imgPixels = (uint32_t)fr.imgRows * ((80 * fr.spiHalves) / fr.spiScale);
+        uint32_t clipLimitHigh = ((uint32_t)_softAGCClipLimitHigh * imgPixels) / modulePixels;
+        uint32_t clipLimitLow = ((uint32_t)_softAGCClipLimitLow * imgPixels) / modulePixels;
+        uint32_t total = 0, cumulative = 0;
+
+        for (int bin = 0; bin < LEPFLIR_SOFT_AGC_BINS; ++bin)
+            total += (histData[bin] ? min((uint32_t)histData[bin], clipLimitHigh) + clipLimitLow : 0);
+
+        if (total) {
+            for (int bin = 0; bin < LEPFLIR_SOFT_AGC_BINS; ++bin) {
+                cumulative += (histData[bin] ? min((uint32_t)histData[bin], clipLimitHigh) + clipLimitLow : 0);
+                lutData[bin] = (byte)((cumulative * 255) / total);
+            }
+        }
+    }
+    else {
+        uint_fast8_t minBin = softAGCBin(fr.agcMin, _softAGCHistMin, _softAGCHistShift);
+        uint_fast8_t maxBin = softAGCBin(fr.agcMax, _softAGCHistMin, _softAGCHistShift);
+
+        for (int bin = 0; bin < LEPFLIR_SOFT_AGC_BINS; ++bin)
+            lutData[bin] = (byte)(bin <= minBin ? 0 : (bin >= maxBin ? 255 : ((bin - minBin) * 255) / (maxBin - minBin)));
+    }
+
+    _softAGCLutMin = _softAGCHistMin;
+    _softAGCLutShift = _softAGCHistShift;
+
+    _softAGCHistMin = fr.agcMin;
+    _softAGCHistShift = 0;
+    while (((uint16_t)(fr.agcMax - fr.agcMin) >> _softAGCHistShift) >= LEPFLIR_SOFT_AGC_BINS)
+        ++_softAGCHistShift;
+}
+
+// Gradient stops of the module's pseudo color LUTs, in LEP_VID_PCOLOR_LUT order, as index,
+// red, green, blue, with each LUT running from index 0 up to and ending at index 255.
+static const byte paletteStops[] PROGMEM = {
+    // LEP_VID_WHEEL6_LUT
+    0, 255, 0, 0,       51, 255, 255, 0,    102, 0, 255, 0,     153, 0, 255, 255,
+    204, 0, 0, 255,     255, 255, 0, 255,
+    // LEP_VID_FUSION_LUT
+    0, 0, 0, 0,         48, 64, 0, 128,     96, 160, 0, 128,    144, 224, 64, 32,
+    192, 255, 160, 0,   232, 255, 224, 64,  255, 255, 255, 255,
+    // LEP_VID_RAINBOW_LUT
+    0, 0, 0, 96,        40, 0, 0, 255,      80, 0, 255, 255,    128, 0, 255, 0,
+    176, 255, 255, 0,   216, 255, 0, 0,     255, 255, 255, 255,
+    // LEP_VID_GLOBOW_LUT
+    0, 0, 0, 0,         56, 96, 32, 160,    112, 0, 160, 96,    176, 224, 192, 0,
+    224, 255, 128, 64,  255, 255, 255, 255,
+    // LEP_VID_SEPIA_LUT
+    0, 0, 0, 0,         128, 150, 100, 60,  255, 255, 240, 210,
+    // LEP_VID_COLOR_LUT
+    0, 0, 0, 0,         64, 0, 0, 255,      128, 0, 255, 0,     192, 255, 0, 0,
+    255, 255, 255, 255,
+    // LEP_VID_ICE_FIRE_LUT
+    0, 255, 255, 255,   40, 0, 255, 255,    96, 0, 0, 255,      128, 0, 0, 0,
+    160, 255, 0, 0,     216, 255, 255, 0,   255, 255, 255, 255,
+    // LEP_VID_RAIN_LUT
+    0, 0, 0, 0,         64, 0, 0, 192,      128, 0, 192, 192,   192, 192, 192, 255,
+    255, 255, 255, 255
+};
+
+static inline void writeColor(byte *colorData, LeptonFLiR_ColorFormat format, byte red, byte green, byte blue) {
+    uint16_t color = ((uint16_t)(red & 0xF8) << 8) | ((uint16_t)(green & 0xFC) << 3) | (blue >> 3);
+    switch (format) {
+        case LeptonFLiR_ColorFormat_RGB565:
+            memcpy(colorData, &color, 2);
+            break;
+        case LeptonFLiR_ColorFormat_RGB565_BigEndian:
+            colorData[0] = (byte)(color >> 8); colorData[1] = (byte)(color & 0xFF);
+            break;
+        case LeptonFLiR_ColorFormat_RGB888:
+            colorData[0] = red; colorData[1] = green; colorData[2] = blue;
+            break;
+        case LeptonFLiR_ColorFormat_BGR888:
+            colorData[0] = blue; colorData[1] = green; colorData[2] = red;
+            break;
+        default:
+            break;
+    }
+}
+
+// Palette entries are kept in the layout of the color format, making expansion a copy
+template<int ColorBpp> static inline void colorizePixels(byte *valueData, int count, byte *paletteData, byte *colorData) {
+    while (count--) {
+        byte *color = paletteData + (*valueData++ * ColorBpp);
+        colorData[0] = color[0];
+        colorData[1] = color[1];
+        if (ColorBpp == 3) colorData[2] = color[2];
+        colorData += ColorBpp;
+    }
+}
+
+int LeptonFLiR::getColorBpp(LeptonFLiR_ColorFormat format) {
+    return (format == LeptonFLiR_ColorFormat_RGB565 || format == LeptonFLiR_ColorFormat_RGB565_BigEndian ? 2 : 3);
+}
+
+int LeptonFLiR::getPaletteBytes(LeptonFLiR_ColorFormat format) {
+    return 256 * getColorBpp(format);
+}
+
+void LeptonFLiR::makePalette(LEP_VID_PCOLOR_LUT table, LeptonFLiR_ColorFormat format, byte *paletteData, LEP_VID_LUT_BUFFER *userTable) {
+    if (!paletteData) return;
+    int colorBpp = getColorBpp(format);
+
+    if ((int)table < (int)LEP_VID_WHEEL6_LUT || (int)table >= (int)LEP_VID_USER_LUT) {
+        for (int bin = 0; bin < 256; ++bin, paletteData += colorBpp) {
+            if (userTable)
+                writeColor(paletteData, format, userTable->bin[bin].red, userTable->bin[bin].green, userTable->bin[bin].blue);
+            else
+                writeColor(paletteData, format, (byte)bin, (byte)bin, (byte)bin);
+        }
+        return;
+    }
+
+    const byte *stop = paletteStops;
+    for (int tablesLeft = (int)table; tablesLeft > 0; stop += 4) {
+        if (pgm_read_byte(stop) == 255) --tablesLeft;
+    }
+
+    byte begin[4], end[4];
+    for (int i = 0; i < 4; ++i) begin[i] = pgm_read_byte(stop + i);
+    stop += 4;
+    for (int i = 0; i < 4; ++i) end[i] = pgm_read_byte(stop + i);
+
+    for (int bin = 0; bin < 256; ++bin, paletteData += colorBpp) {
+        if (bin > end[0]) {
+            memcpy(begin, end, 4);
+            stop += 4;
+            for (int i = 0; i < 4; ++i) end[i] = pgm_read_byte(stop + i);
+        }
+
+        int span = end[0] - begin[0], offset = bin - begin[0];
+        byte color[3];
+        for (int i = 0; i < 3; ++i)
+            color[i] = (byte)(span ? begin[i + 1] + (((int)end[i + 1] - begin[i + 1]) * offset) / span : end[i + 1]);
+        writeColor(paletteData, format, color[0], color[1], color[2]);
+    }
+}
+
+void LeptonFLiR::colorizeRow(byte *rowData, byte *paletteData, LeptonFLiR_ColorFormat format, byte *colorData) {
+    if (!rowData || !paletteData || !colorData) return;
+    int width = getImageWidth();
+    int colorBpp = getColorBpp(format);
+
+    if (getImageBpp() == 1) {
+        if (colorBpp == 2)
+            colorizePixels<2>(rowData, width, paletteData, colorData);
+        else
+            colorizePixels<3>(rowData, width, paletteData, colorData);
+        return;
+    }
+
+    // 16bpp image data is mapped down to 8-bit a few pixels at a time
+    bool agc8Enabled = _agcEnabled && _heqScaleFactor == LEP_AGC_SCALE_TO_8_BITS;
+    uint16_t *pxlData = (uint16_t *)rowData;
+    byte valueData[16];
+
+    for (int col = 0; col < width; col += 16) {
+        int count = min(16, width - col);
+        for (int i = 0; i < count; ++i) {
+            uint16_t value = *pxlData++;
+            valueData[i] = (agc8Enabled ? (byte)min(value, (uint16_t)0xFF) : getSoftAGCValue(value));
+        }
+
+        if (colorBpp == 2)
+            colorizePixels<2>(valueData, count, paletteData, colorData);
+        else
+            colorizePixels<3>(valueData, count, paletteData, colorData);
+        colorData += count * colorBpp;
+    }
+}
+
+void LeptonFLiR::colorizeImage(byte *paletteData, LeptonFLiR_ColorFormat format, byte *colorData, int colorPitch) {
+    byte *imageData = getImageData();
+    if (!imageData || !colorData) return;
+    int height = getImageHeight(), pitch = getImagePitch();
+
+    for (int row = 0; row < height; ++row, imageData += pitch, colorData += colorPitch)
+        colorizeRow(imageData, paletteData, format, colorData);
+}
+
+// Writes out a run of scaled image data values, either as is or expanded through a palette
+void LeptonFLiR::writeScaledPixels(uint16_t *valueData, int count, byte *paletteData, LeptonFLiR_ColorFormat format, byte *destData) {
+    if (!paletteData) {
+        if (getImageBpp() == 2)
+            memcpy(destData, valueData, count * 2);
+        else
+            while (count--) *destData++ = (byte)*valueData++;
+        return;
+    }
+
+    bool agc8Enabled = _agcEnabled && _heqScaleFactor == LEP_AGC_SCALE_TO_8_BITS;
+    bool valueBpp1 = (getImageBpp() == 1 || agc8Enabled);
+    byte displayData[16];
+
+    for (int i = 0; i < count; ++i)
+        displayData[i] = (valueBpp1 ? (byte)min(valueData[i], (uint16_t)0xFF) : getSoftAGCValue(valueData[i]));
+
+    if (getColorBpp(format) == 2)
+        colorizePixels<2>(displayData, count, paletteData, destData);
+    else
+        colorizePixels<3>(displayData, count, paletteData, destData);
+}
+
+void LeptonFLiR::scaleImageRow(int destRow, byte *destData, int destWidth, int destHeight, LeptonFLiR_ScaleFilter filter, byte *paletteData, LeptonFLiR_ColorFormat format) {
+    byte *imageData = getImageData();
+    if (!imageData || !destData || destWidth <= 0 || destHeight <= 0 || destRow < 0 || destRow >= destHeight) return;
+
+    int width = getImageWidth(), height = getImageHeight(), pitch = getImagePitch();
+    bool imgBpp2 = getImageBpp() == 2;
+    int destBpp = (paletteData ? getColorBpp(format) : getImageBpp());
+
+    // 16.16 fixed-point steps, sampling at destination pixel centers
+    int32_t stepX = ((int32_t)width << 16) / destWidth;
+    int32_t stepY = ((int32_t)height << 16) / destHeight;
+    int32_t posX = (stepX >> 1), posY = (destRow * stepY) + (stepY >> 1);
+    uint16_t valueData[16];
+
+    if (filter == LeptonFLiR_ScaleFilter_Bilinear) {
+        // Interpolates between the four nearest pixel centers, with 8-bit weights
+        posX -= 0x8000; posY -= 0x8000;
+        if (posY < 0) posY = 0;
+        int row = (int)(posY >> 16);
+        uint32_t fracY = (uint32_t)((posY >> 8) & 0xFF);
+        byte *rowData0 = imageData + (row * pitch);
+        byte *rowData1 = (row + 1 < height ? rowData0 + pitch : rowData0);
+
+        for (int col = 0; col < destWidth; col += 16) {
+            int count = min(16, destWidth - col);
+            for (int i = 0; i < count; ++i, posX += stepX) {
+                int32_t pos = (posX > 0 ? posX : 0);
+                int col0 = (int)(pos >> 16), col1 = (col0 + 1 < width ? col0 + 1 : col0);
+                uint32_t fracX = (uint32_t)((pos >> 8) & 0xFF);
+                uint32_t value00, value01, value10, value11;
+
+                if (imgBpp2) {
+                    value00 = ((uint16_t *)rowData0)[col0]; value01 = ((uint16_t *)rowData0)[col1];
+                    value10 = ((uint16_t *)rowData1)[col0]; value11 = ((uint16_t *)rowData1)[col1];
+                }
+                else {
+                    value00 = rowData0[col0]; value01 = rowData0[col1];
+                    value10 = rowData1[col0]; value11 = rowData1[col1];
+                }
+
+                uint32_t top = (value00 * (256 - fracX)) + (value01 * fracX);
+                uint32_t bottom = (value10 * (256 - fracX)) + (value11 * fracX);
+                valueData[i] = (uint16_t)(((top * (256 - fracY)) + (bottom * fracY) + 0x8000) >> 16);
+            }
+
+            writeScaledPixels(valueData, count, paletteData, format, destData);
+            destData += count * destBpp;
+        }
+    }
+    else {
+        byte *rowData = imageData + ((int)(posY >> 16) * pitch);
+
+        for (int col = 0; col < destWidth; col += 16) {
+            int count = min(16, destWidth - col);
+            for (int i = 0; i < count; ++i, posX += stepX)
+                valueData[i] = (imgBpp2 ? ((uint16_t *)rowData)[posX >> 16] : rowData[posX >> 16]);
+
+            writeScaledPixels(valueData, count, paletteData, format, destData);
+            destData += count * destBpp;
+        }
+    }
+}
+
+void LeptonFLiR::scaleImage(byte *destData, int destWidth, int destHeight, int destPitch, LeptonFLiR_ScaleFilter filter, byte *paletteData, LeptonFLiR_ColorFormat format) {
+    if (!destData) return;
+
+    for (int destRow = 0; destRow < destHeight; ++destRow, destData += destPitch)
+        scaleImageRow(destRow, destData, destWidth, destHeight, filter, paletteData, format);
+}
+
+uint32_t LeptonFLiR::getDuplicateFramesSkipped() {
+    return _duplicateFramesSkipped;
+}
+
+void LeptonFLiR::setTransport(LeptonFLiRTransport *transport) {
+    if (_spiFrameData) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::setTransport Transport must be set before init. Ignoring.");
+#endif
+        return;
+    }
+
+    _transport = transport ? transport : &_defaultTransport;
+}
+
+LeptonFLiRTransport *LeptonFLiR::getTransport() {
+    return _transport;
+}
+
+void LeptonFLiR::setMemoryArena(byte *arena, int arenaBytes) {
+    if (_imageData || _imageRowData || _spiFrameData) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::setMemoryArena Memory arena must be set before init. Ignoring.");
+#endif
+        return;
+    }
+
+    if (_telemetryData) // move over telemetry data storage already allocated
+        freeTelemetryData();
+
+    if (_shadowCache && arena) { // carved out of the arena by init instead
+        free(_shadowCache);
+        _shadowCache = NULL;
+    }
+
+    _memoryArena = arena;
+    _memoryArenaBytes = arena ? arenaBytes : 0;
+
+    if (_telemetryEnabled)
+        _telemetryData = allocTelemetryData();
+
+    if (_shadowCacheEnabled && !_memoryArena && !_shadowCache) {
+        _shadowCache = (LeptonConfigProfile *)malloc(sizeof(LeptonConfigProfile));
+        invalidateShadowCache();
+    }
+}
+
+byte *LeptonFLiR::getMemoryArena() {
+    return _memoryArena;
+}
+
+void LeptonFLiR::setPacketCRCEnabled(bool enabled) {
+    _packetCRCEnabled = enabled;
+}
+
+bool LeptonFLiR::getPacketCRCEnabled() {
+    return _packetCRCEnabled;
+}
+
+uint16_t LeptonFLiR::getFrameCRCErrors() {
+    return _frameCRCErrors;
+}
+
+uint32_t LeptonFLiR::getTotalCRCErrors() {
+    return _totalCRCErrors;
+}
+
+void LeptonFLiR::resetCRCErrors() {
+    _frameCRCErrors = 0;
+    _totalCRCErrors = 0;
+}
+
 int LeptonFLiR::getImageWidth() {
     switch (_storageMode) {
         case LeptonFLiR_ImageStorageMode_80x60_16bpp:
@@ -166,6 +772,15 @@ int LeptonFLiR::getImageWidth() {
         case LeptonFLiR_ImageStorageMode_20x15_16bpp:
         case LeptonFLiR_ImageStorageMode_20x15_8bpp:
             return 20;
+        case LeptonFLiR_ImageStorageMode_L3_160x120_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_160x120_8bpp:
+            return 160;
+        case LeptonFLiR_ImageStorageMode_L3_80x60_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_80x60_8bpp:
+            return 80;
+        case LeptonFLiR_ImageStorageMode_L3_40x30_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_40x30_8bpp:
+            return 40;
         default:
             return 0;
     }
@@ -182,6 +797,15 @@ int LeptonFLiR::getImageHeight() {
         case LeptonFLiR_ImageStorageMode_20x15_16bpp:
         case LeptonFLiR_ImageStorageMode_20x15_8bpp:
             return 15;
+        case LeptonFLiR_ImageStorageMode_L3_160x120_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_160x120_8bpp:
+            return 120;
+        case LeptonFLiR_ImageStorageMode_L3_80x60_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_80x60_8bpp:
+            return 60;
+        case LeptonFLiR_ImageStorageMode_L3_40x30_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_40x30_8bpp:
+            return 30;
         default:
             return 0;
     }
@@ -192,10 +816,16 @@ int LeptonFLiR::getImageBpp() {
         case LeptonFLiR_ImageStorageMode_80x60_16bpp:
         case LeptonFLiR_ImageStorageMode_40x30_16bpp:
         case LeptonFLiR_ImageStorageMode_20x15_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_160x120_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_80x60_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_40x30_16bpp:
             return 2;
         case LeptonFLiR_ImageStorageMode_80x60_8bpp:
         case LeptonFLiR_ImageStorageMode_40x30_8bpp:
         case LeptonFLiR_ImageStorageMode_20x15_8bpp:
+        case LeptonFLiR_ImageStorageMode_L3_160x120_8bpp:
+        case LeptonFLiR_ImageStorageMode_L3_80x60_8bpp:
+        case LeptonFLiR_ImageStorageMode_L3_40x30_8bpp:
             return 1;
         default:
             return 0;
@@ -216,6 +846,18 @@ int LeptonFLiR::getImagePitch() {
             return roundUpVal16(20 * 2);
         case LeptonFLiR_ImageStorageMode_20x15_8bpp:
             return roundUpVal16(20 * 1);
+        case LeptonFLiR_ImageStorageMode_L3_160x120_16bpp:
+            return roundUpVal16(160 * 2);
+        case LeptonFLiR_ImageStorageMode_L3_160x120_8bpp:
+            return roundUpVal16(160 * 1);
+        case LeptonFLiR_ImageStorageMode_L3_80x60_16bpp:
+            return roundUpVal16(80 * 2);
+        case LeptonFLiR_ImageStorageMode_L3_80x60_8bpp:
+            return roundUpVal16(80 * 1);
+        case LeptonFLiR_ImageStorageMode_L3_40x30_16bpp:
+            return roundUpVal16(40 * 2);
+        case LeptonFLiR_ImageStorageMode_L3_40x30_8bpp:
+            return roundUpVal16(40 * 1);
         default:
             return 0;
     }
@@ -225,31 +867,107 @@ int LeptonFLiR::getImageTotalBytes() {
     return ((getImageHeight() - 1) * getImagePitch()) + (getImageWidth() * getImageBpp());
 }
 
+int LeptonFLiR::getImageBuffersTotalBytes() {
+    if (_imageRowFunc) return getImagePitch(); // single row, reused between rows
+    return ((_frameBufferCount - 1) * roundUpVal16(getImageTotalBytes())) + getImageTotalBytes();
+}
+
+byte *LeptonFLiR::getImageBuffer(int buffer) {
+    return _imageBuffers[buffer];
+}
+
 byte *LeptonFLiR::getImageData() {
-    return !_isReadingNextFrame && _imageData ? roundUpPtr16(_imageData) : NULL;
+    return !(_isReadingNextFrame && _frameBufferCount == 1) ? getImageBuffer(_frontBuffer) : NULL;
+}
+
+byte *LeptonFLiR::getImageData(uint32_t *frameNumber) {
+    if (_isReadingNextFrame && _frameBufferCount == 1) return NULL;
+    byte frontBuffer = _frontBuffer;
+    if (frameNumber) *frameNumber = _frameNumbers[frontBuffer];
+    return getImageBuffer(frontBuffer);
 }
 
 byte *LeptonFLiR::getImageDataRow(int row) {
-    return !_isReadingNextFrame && _imageData ? (roundUpPtr16(_imageData) + (row * getImagePitch())) : NULL;
+    return !(_isReadingNextFrame && _frameBufferCount == 1) && _imageData ? (getImageBuffer(_frontBuffer) + (row * getImagePitch())) : NULL;
 }
 
 byte *LeptonFLiR::_getImageDataRow(int row) {
-    return _imageData ? roundUpPtr16(_imageData) + (getImagePitch() * row) : NULL;
+    return _imageData ? getImageBuffer(_backBuffer) + (getImagePitch() * row) : NULL;
 }
 
 uint16_t LeptonFLiR::getImageDataRowCol(int row, int col) {
-    if (_isReadingNextFrame || !_imageData) return 0;
-    byte *imageData = roundUpPtr16(_imageData) + (row * getImagePitch()) + (col * getImageBpp());
+    if ((_isReadingNextFrame && _frameBufferCount == 1) || !_imageData) return 0;
+    byte *imageData = getImageBuffer(_frontBuffer) + (row * getImagePitch()) + (col * getImageBpp());
     return getImageBpp() == 2 ? *((uint16_t *)imageData) : (uint16_t)(*imageData);
 }
 
+void LeptonFLiR::setFrameBufferCount(byte count) {
+    if (_imageData || _imageRowData || _spiFrameData) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::setFrameBufferCount Frame buffer count must be set before init. Ignoring.");
+#endif
+        return;
+    }
+
+    if (_telemetryData) // resize telemetry data storage already allocated
+        freeTelemetryData();
+
+    _frameBufferCount = constrain(count, 1, 3);
+
+    if (_telemetryEnabled)
+        _telemetryData = allocTelemetryData();
+}
+
+byte LeptonFLiR::getFrameBufferCount() {
+    return _frameBufferCount;
+}
+
+uint32_t LeptonFLiR::getFrameNumber() {
+    return _frameNumbers[_frontBuffer];
+}
+
+byte *LeptonFLiR::getTelemetryBuffer(int buffer) {
+    return _telemetryData ? _telemetryData + (buffer * LEPFLIR_SPI_FRAME_PACKET_SIZE) : NULL;
+}
+
+byte *LeptonFLiR::allocTelemetryData() {
+    byte *arenaData = _memoryArena;
+    byte *telemetryData = (_memoryArena ? roundUpCarve16(&arenaData, _memoryArena + _memoryArenaBytes, _frameBufferCount * LEPFLIR_SPI_FRAME_PACKET_SIZE) :
+        (byte *)malloc(_frameBufferCount * LEPFLIR_SPI_FRAME_PACKET_SIZE));
+
+    if (telemetryData) {
+        for (int buffer = 0; buffer < _frameBufferCount; ++buffer)
+            telemetryData[buffer * LEPFLIR_SPI_FRAME_PACKET_SIZE] = telemetryData[(buffer * LEPFLIR_SPI_FRAME_PACKET_SIZE) + 1] = 0xFF; // initialize as discard packet
+    }
+
+    return telemetryData;
+}
+
+void LeptonFLiR::freeTelemetryData() {
+    if (!_memoryArena)
+        free(_telemetryData);
+    _telemetryData = NULL;
+}
+
+void LeptonFLiR::swapFrameBuffers() {
+    byte frontBuffer = _frontBuffer;
+    _frameNumbers[_backBuffer] = ++_framesRead;
+    _frontBuffer = _backBuffer; // single byte write, so readers never see a half swap
+
+    if (_frameBufferCount == 2)
+        _backBuffer = frontBuffer;
+    else if (_frameBufferCount == 3)
+        _backBuffer = 3 - frontBuffer - _backBuffer;
+}
+
 byte *LeptonFLiR::getTelemetryData() {
-    return !_isReadingNextFrame && _telemetryData && !(*((uint16_t *)_telemetryData) & 0x0F00 == 0x0F00) ? _telemetryData : NULL;
+    byte *telemetryData = getTelemetryBuffer(_frontBuffer);
+    return !(_isReadingNextFrame && _frameBufferCount == 1) && telemetryData && !(*((uint16_t *)telemetryData) & 0x0F00 == 0x0F00) ? telemetryData : NULL;
 }
 
 void LeptonFLiR::getTelemetryData(TelemetryData *telemetry) {
-    if (_isReadingNextFrame || !_telemetryData || !telemetry) return;
-    uint16_t *telemetryData = (uint16_t *)&_telemetryData[4];
+    if ((_isReadingNextFrame && _frameBufferCount == 1) || !_telemetryData || !telemetry) return;
+    uint16_t *telemetryData = (uint16_t *)&getTelemetryBuffer(_frontBuffer)[4];
 
     telemetry->revisionMajor = lowByte(telemetryData[0]);
     telemetry->revisionMinor = highByte(telemetryData[0]);
@@ -289,15 +1007,15 @@ void LeptonFLiR::getTelemetryData(TelemetryData *telemetry) {
 }
 
 uint32_t LeptonFLiR::getTelemetryFrameCounter() {
-    if (_isReadingNextFrame || !_telemetryData) return 0;
-    uint16_t *telemetryData = (uint16_t *)&_telemetryData[4];
+    if ((_isReadingNextFrame && _frameBufferCount == 1) || !_telemetryData) return 0;
+    uint16_t *telemetryData = (uint16_t *)&getTelemetryBuffer(_frontBuffer)[4];
 
     return ((uint32_t)telemetryData[20] << 16) | (uint32_t)telemetryData[21];
 }
 
 bool LeptonFLiR::getShouldRunFFCNormalization() {
-    if (_isReadingNextFrame || !_telemetryData) return false;
-    uint16_t *telemetryData = (uint16_t *)&_telemetryData[4];
+    if ((_isReadingNextFrame && _frameBufferCount == 1) || !_telemetryData) return false;
+    uint16_t *telemetryData = (uint16_t *)&getTelemetryBuffer(_frontBuffer)[4];
 
     uint_fast8_t ffcState = (telemetryData[4] & 0x0018) >> 3;
     if (lowByte(telemetryData[0]) >= 9 && ffcState >= 1)
@@ -306,30 +1024,83 @@ bool LeptonFLiR::getShouldRunFFCNormalization() {
     return (telemetryData[4] & 0x0004) && ffcState != (uint_fast8_t)TelemetryData_FFCState_InProgress;
 }
 
+bool LeptonFLiR::isLepton3StorageMode() {
+    return _storageMode >= LeptonFLiR_ImageStorageMode_L3_160x120_16bpp && _storageMode < LeptonFLiR_ImageStorageMode_Count;
+}
+
 int LeptonFLiR::getSPIFrameLines() {
+    // Packets per image row (Lepton 3.x sends each 160 pixel line as two packets)
     switch (_storageMode) {
         case LeptonFLiR_ImageStorageMode_80x60_16bpp:
         case LeptonFLiR_ImageStorageMode_80x60_8bpp:
             return 1;
         case LeptonFLiR_ImageStorageMode_40x30_16bpp:
         case LeptonFLiR_ImageStorageMode_40x30_8bpp:
+        case LeptonFLiR_ImageStorageMode_L3_160x120_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_160x120_8bpp:
             return 2;
         case LeptonFLiR_ImageStorageMode_20x15_16bpp:
         case LeptonFLiR_ImageStorageMode_20x15_8bpp:
+        case LeptonFLiR_ImageStorageMode_L3_80x60_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_80x60_8bpp:
             return 4;
+        case LeptonFLiR_ImageStorageMode_L3_40x30_16bpp:
+        case LeptonFLiR_ImageStorageMode_L3_40x30_8bpp:
+            return 8;
         default:
             return 0;
     }
 }
 
+int LeptonFLiR::getSPIFrameSlots() {
+    // One packet buffer, plus one for asynchronous transports to receive into while processing
+    return 1 + (_transport->isAsynchronous() ? 1 : 0);
+}
+
+int LeptonFLiR::getSPIFrameSumBytes() {
+    // Column sums of the image row being downscaled, 32-bit as TLinear data is 16 bits wide
+    int spiScale = getSPIFrameLines() / (isLepton3StorageMode() ? 2 : 1);
+    return spiScale > 1 ? getImageWidth() * 4 : 0;
+}
+
+int LeptonFLiR::getSPIFrameCarryBytes() {
+    // Lepton 3.x segments also need room to carry over a partial image row (see saveSPIFrameSegment)
+    return isLepton3StorageMode() ? getSPIFrameSumBytes() + (_imageRowFunc ? getImagePitch() : 0) : 0;
+}
+
 int LeptonFLiR::getSPIFrameTotalBytes() {
-    return getSPIFrameLines() * roundUpVal16(LEPFLIR_SPI_FRAME_PACKET_SIZE);
+    return (getSPIFrameSlots() * roundUpVal16(LEPFLIR_SPI_FRAME_PACKET_SIZE)) + roundUpVal16(getSPIFrameSumBytes()) + roundUpVal16(getSPIFrameCarryBytes());
 }
 
 uint16_t *LeptonFLiR::getSPIFrameDataRow(int row) {
     return (uint16_t *)(roundUpSpiFrame16(_spiFrameData) + (row * roundUpVal16(LEPFLIR_SPI_FRAME_PACKET_SIZE)));
 }
 
+byte *LeptonFLiR::getSPIFrameSumData() {
+    return _spiFrameData ? roundUpPtr16(_spiFrameData) + (getSPIFrameSlots() * roundUpVal16(LEPFLIR_SPI_FRAME_PACKET_SIZE)) : NULL;
+}
+
+byte *LeptonFLiR::getSPIFrameCarryData() {
+    return _spiFrameData ? getSPIFrameSumData() + roundUpVal16(getSPIFrameSumBytes()) : NULL;
+}
+
+// Saves the column sums (and image row buffer) of a partially assembled image row at the
+// start of a Lepton 3.x segment, since they get written to before the segment number is known.
+void LeptonFLiR::saveSPIFrameSegment() {
+    int sumBytes = getSPIFrameSumBytes();
+    memcpy(getSPIFrameCarryData(), getSPIFrameSumData(), sumBytes);
+    if (_imageRowData)
+        memcpy(getSPIFrameCarryData() + sumBytes, roundUpPtr16(_imageRowData), getImagePitch());
+}
+
+// Restores the partial image row saved by saveSPIFrameSegment, for when a segment is discarded.
+void LeptonFLiR::restoreSPIFrameSegment() {
+    int sumBytes = getSPIFrameSumBytes();
+    memcpy(getSPIFrameSumData(), getSPIFrameCarryData(), sumBytes);
+    if (_imageRowData)
+        memcpy(roundUpPtr16(_imageRowData), getSPIFrameCarryData() + sumBytes, getImagePitch());
+}
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
 
 static void printSPIFrame(uint16_t *spiFrame) {
@@ -364,295 +1135,730 @@ static void delayTimeout(int timeout) {
     }
 }
 
-static void SPI_transfer16(uint16_t *buffer, int count) {
-    while (count-- > 0)
-        *buffer++ = SPI.transfer16(0x0000);
-}
-
 static void SPI_ignore16(int count) {
     while (count-- > 0)
         SPI.transfer16(0x0000);
 }
 
-//#define LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT    1
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+static uint32_t _spiPacketsRead;
+static uint32_t _spiPacketMicros;
+#endif
 
-bool LeptonFLiR::readNextFrame() {
-    if (!_isReadingNextFrame) {
-        _isReadingNextFrame = true;
+static void SPI_submitPacket(LeptonFLiRTransport *transport, uint16_t *spiFrame) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    unsigned long startTime = micros();
+#endif
+
+    transport->submitPacketRead(spiFrame);
 
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-        Serial.println("LeptonFLiR::readNextFrame");
+    _spiPacketMicros += micros() - startTime;
+    ++_spiPacketsRead;
 #endif
+}
 
-        bool agc8Enabled;
-        LEP_SYS_TELEMETRY_LOCATION telemetryLocation;
+static void SPI_waitPacket(LeptonFLiRTransport *transport) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    unsigned long startTime = micros();
+#endif
 
-        {   bool telemetryEnabled, cameraBooted, stateErrors = false;
-            uint32_t value = 0;
+    while (!transport->isPacketReadComplete());
 
-            receiveCommand(cmdCode(LEP_CID_AGC_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &value);
-            agc8Enabled = value;
-            stateErrors = stateErrors || _lastI2CError || _lastLepResult;
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    _spiPacketMicros += micros() - startTime;
+#endif
+}
 
-            if (agc8Enabled) {
-                receiveCommand(cmdCode(LEP_CID_AGC_HEQ_SCALE_FACTOR, LEP_I2C_COMMAND_TYPE_GET), &value);
-                agc8Enabled = (value == (uint32_t)LEP_AGC_SCALE_TO_8_BITS);
-                stateErrors = stateErrors || _lastI2CError || _lastLepResult;
-            }
+static void SPI_transferPacket(LeptonFLiRTransport *transport, uint16_t *spiFrame) {
+    SPI_submitPacket(transport, spiFrame);
+    SPI_waitPacket(transport);
+}
 
-            receiveCommand(cmdCode(LEP_CID_SYS_TELEMETRY_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &value);
-            telemetryEnabled = value;
-            stateErrors = stateErrors || _lastI2CError || _lastLepResult;
+// Downscale kernels, each taking in one packet as it arrives (a row, or half a row for
+// Lepton 3.x). Scaled modes sum each packet row into per column sums, writing out the image
+// row once its last packet row arrives. Division by the pixel count (and by 64 for 14bpp to
+// 8bpp) is done with a shift. Samples may be full 16-bit (e.g. TLinear), so each is summed
+// on its own into 32-bit column sums.
 
-            if (telemetryEnabled) {
-                receiveCommand(cmdCode(LEP_CID_SYS_TELEMETRY_LOCATION, LEP_I2C_COMMAND_TYPE_GET), &value);
-                telemetryLocation = (LEP_SYS_TELEMETRY_LOCATION)value;
-                stateErrors = stateErrors || _lastI2CError || _lastLepResult;
-            }
+static void downscalePacket1x1_16bpp(byte *pxlData, byte * /*sumData*/, uint16_t *spiData, uint_fast8_t /*spiRow*/, uint_fast8_t /*shift*/, uint16_t /*clamp*/) {
+    memcpy(pxlData, spiData, LEPFLIR_SPI_FRAME_PACKET_SIZE - 4);
+}
+
+static void downscalePacket1x1_8bpp(byte *pxlData, byte * /*sumData*/, uint16_t *spiData, uint_fast8_t /*spiRow*/, uint_fast8_t shift, uint16_t clamp) {
+    uint_fast8_t imgWidth = LEPFLIR_SPI_FRAME_PACKET_SIZE16 - 2;
+
+    while (imgWidth--) {
+        uint16_t value = *spiData++ >> shift;
+        *pxlData++ = (byte)(value < clamp ? value : clamp);
+    }
+}
+
+template <typename PixelType>
+static void downscalePacket2x2(byte *pxlData, byte *sumData, uint16_t *spiData, uint_fast8_t spiRow, uint_fast8_t shift, uint16_t clamp) {
+    uint32_t *colSums = (uint32_t *)sumData;
+    uint_fast8_t imgWidth = (LEPFLIR_SPI_FRAME_PACKET_SIZE16 - 2) / 2;
+
+    if (spiRow == 0) {
+        while (imgWidth--) {
+            *colSums++ = (uint32_t)spiData[0] + spiData[1];
+            spiData += 2;
+        }
+    }
+    else {
+        PixelType *imgData = (PixelType *)pxlData;
+        while (imgWidth--) {
+            uint32_t value = (*colSums++ + spiData[0] + spiData[1]) >> shift;
+            *imgData++ = (PixelType)(value < clamp ? value : clamp);
+            spiData += 2;
+        }
+    }
+}
+
+template <typename PixelType>
+static void downscalePacket4x4(byte *pxlData, byte *sumData, uint16_t *spiData, uint_fast8_t spiRow, uint_fast8_t shift, uint16_t clamp) {
+    uint32_t *colSums = (uint32_t *)sumData;
+    uint_fast8_t imgWidth = (LEPFLIR_SPI_FRAME_PACKET_SIZE16 - 2) / 4;
+
+    if (spiRow == 0) {
+        while (imgWidth--) {
+            *colSums++ = (uint32_t)spiData[0] + spiData[1] + spiData[2] + spiData[3];
+            spiData += 4;
+        }
+    }
+    else if (spiRow < 3) {
+        while (imgWidth--) {
+            *colSums++ += (uint32_t)spiData[0] + spiData[1] + spiData[2] + spiData[3];
+            spiData += 4;
+        }
+    }
+    else {
+        PixelType *imgData = (PixelType *)pxlData;
+        while (imgWidth--) {
+            uint32_t value = (*colSums++ + spiData[0] + spiData[1] + spiData[2] + spiData[3]) >> shift;
+            *imgData++ = (PixelType)(value < clamp ? value : clamp);
+            spiData += 4;
+        }
+    }
+}
+
+static void resetFrameStats(FrameStats *stats, uint16_t threshold) {
+    memset(stats, 0, sizeof(FrameStats));
+    stats->minValue = 0xFFFF;
+    stats->threshold = threshold;
+}
+
+// Accumulates frame statistics from an image row, keeping the first min/max location found
+template <typename PixelType>
+static void accumulateFrameStats(FrameStats *stats, byte *rowData, uint_fast8_t row, uint_fast8_t imgWidth) {
+    PixelType *imgData = (PixelType *)rowData;
+    uint16_t minValue = stats->minValue, maxValue = stats->maxValue, threshold = stats->threshold;
+    uint32_t sum = 0;
+    uint16_t thresholdCount = 0;
+
+    for (uint_fast8_t col = 0; col < imgWidth; ++col) {
+        uint16_t value = *imgData++;
+        sum += value;
+        if (value >= threshold) ++thresholdCount;
+        if (value < minValue) { minValue = value; stats->minRow = row; stats->minCol = col; }
+        if (value > maxValue) { maxValue = value; stats->maxRow = row; stats->maxCol = col; }
+    }
 
-            uint16_t status; readRegister(LEP_I2C_STATUS_REG, &status);
+    stats->minValue = minValue; stats->maxValue = maxValue;
+    stats->sum += sum;
+    stats->thresholdCount += thresholdCount;
+}
+
+bool LeptonFLiR::refreshCaptureState() {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-            checkForErrors();
+    Serial.println("LeptonFLiR::refreshCaptureState");
 #endif
-            cameraBooted = (status & LEP_I2C_STATUS_BOOT_MODE_BIT_MASK) && (status & LEP_I2C_STATUS_BOOT_STATUS_BIT_MASK);
-            stateErrors = stateErrors || _lastI2CError || _lastLepResult;
-            
-            if (stateErrors) {
+
+    bool stateErrors = false, cameraBooted;
+    uint32_t value = 0;
+
+    _captureStateValid = false;
+
+    if (_shadowCacheEnabled)
+        validateShadowCache();
+
+    receiveCommand(cmdCode(LEP_CID_AGC_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &value);
+    _agcEnabled = value;
+    stateErrors = stateErrors || _lastI2CError || _lastLepResult;
+
+    receiveCommand(cmdCode(LEP_CID_AGC_HEQ_SCALE_FACTOR, LEP_I2C_COMMAND_TYPE_GET), &value);
+    _heqScaleFactor = (LEP_AGC_HEQ_SCALE_FACTOR)value;
+    stateErrors = stateErrors || _lastI2CError || _lastLepResult;
+
+    receiveCommand(cmdCode(LEP_CID_SYS_TELEMETRY_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &value);
+    _telemetryEnabled = value;
+    stateErrors = stateErrors || _lastI2CError || _lastLepResult;
+
+    receiveCommand(cmdCode(LEP_CID_SYS_TELEMETRY_LOCATION, LEP_I2C_COMMAND_TYPE_GET), &value);
+    _telemetryLocation = (LEP_SYS_TELEMETRY_LOCATION)value;
+    stateErrors = stateErrors || _lastI2CError || _lastLepResult;
+
+    uint16_t status; readRegister(LEP_I2C_STATUS_REG, &status);
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-                Serial.println("  LeptonFLiR::readNextFrame Errors reading state encountered. Aborting.");
+    checkForErrors();
 #endif
-                _isReadingNextFrame = false;
-                return false;
-            }
+    cameraBooted = (status & LEP_I2C_STATUS_BOOT_MODE_BIT_MASK) && (status & LEP_I2C_STATUS_BOOT_STATUS_BIT_MASK);
+    stateErrors = stateErrors || _lastI2CError || _lastLepResult;
 
-            if (!cameraBooted) {
+    if (stateErrors) {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-                Serial.println("  LeptonFLiR::readNextFrame Camera has not yet booted. Aborting.");
+        Serial.println("  LeptonFLiR::refreshCaptureState Errors reading state encountered.");
 #endif
-                _isReadingNextFrame = false;
-                return false;
-            }
+        return false;
+    }
 
-            if (telemetryEnabled && !_telemetryData) {
-                _telemetryData = (byte *)malloc(LEPFLIR_SPI_FRAME_PACKET_SIZE);
+    if (!cameraBooted) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::refreshCaptureState Camera has not yet booted.");
+#endif
+        return false;
+    }
 
-                if (_telemetryData)
-                    _telemetryData[0] = _telemetryData[1] = 0xFF; // initialize as discard packet
+    if (_telemetryEnabled && !_telemetryData) {
+        _telemetryData = allocTelemetryData();
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-                if (!_telemetryData)
-                    Serial.println("  LeptonFLiR::readNextFrame Failure allocating telemetryData.");
+        if (!_telemetryData)
+            Serial.println("  LeptonFLiR::refreshCaptureState Failure allocating telemetryData.");
 #endif
-            }
-            else if (!telemetryEnabled && _telemetryData) {
-                free(_telemetryData);
-                _telemetryData = NULL;
-            }
-        }
+    }
+    else if (!_telemetryEnabled && _telemetryData) {
+        freeTelemetryData();
+    }
+
+    return (_captureStateValid = true);
+}
+
+void LeptonFLiR::setCaptureState(bool agcEnabled, LEP_AGC_HEQ_SCALE_FACTOR heqScaleFactor, bool telemetryEnabled, LEP_SYS_TELEMETRY_LOCATION telemetryLocation) {
+    _agcEnabled = agcEnabled;
+    _heqScaleFactor = heqScaleFactor;
+    _telemetryEnabled = telemetryEnabled;
+    _telemetryLocation = telemetryLocation;
+
+    if (_telemetryEnabled && !_telemetryData)
+        _telemetryData = allocTelemetryData();
+    else if (!_telemetryEnabled && _telemetryData)
+        freeTelemetryData();
 
+    _captureStateValid = true;
+}
+
+//#define LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT    1
+
+bool LeptonFLiR::readNextFrame() {
+    if (!_isReadingNextFrame) {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-        Serial.print("  LeptonFLiR::readNextFrame AGC-8bit: ");
-        Serial.print(agc8Enabled ? "enabled" : "disabled");
-        Serial.print(", Telemetry: ");
-        if (_telemetryData) {
-            Serial.print("enabled, Location: ");
-            Serial.println(telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER ? "header" : "footer");
-        }
-        else
-            Serial.println("disabled");
+        Serial.println("LeptonFLiR::readNextFrame");
+#endif
+
+        if (!beginFrame())
+            return false;
+
+        LeptonFLiR_FrameStatus status;
+        while ((status = pollFrame()) == LeptonFLiR_FrameStatus_InProgress)
+            delayTimeout(1);
+
+        return status == LeptonFLiR_FrameStatus_FrameReady;
+    }
+
+    return true;
+}
+
+bool LeptonFLiR::beginFrame() {
+    if (_isReadingNextFrame) return false;
+    _isReadingNextFrame = true;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::beginFrame");
+#endif
+
+    if (!_captureStateValid && !refreshCaptureState()) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        Serial.println("  LeptonFLiR::beginFrame Errors refreshing capture state encountered. Aborting.");
 #endif
+        _isReadingNextFrame = false;
+        return false;
+    }
+
+    FrameReadState &fr = _frameRead;
+    fr.agc8Enabled = _agcEnabled && _heqScaleFactor == LEP_AGC_SCALE_TO_8_BITS;
+    fr.telemetryLocation = _telemetryLocation;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.print("  LeptonFLiR::beginFrame AGC-8bit: ");
+    Serial.print(fr.agc8Enabled ? "enabled" : "disabled");
+    Serial.print(", Telemetry: ");
+    if (_telemetryData) {
+        Serial.print("enabled, Location: ");
+        Serial.println(fr.telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER ? "header" : "footer");
+    }
+    else
+        Serial.println("disabled");
+#endif
+
+    fr.spiFrame = NULL;
+    fr.lepton3 = isLepton3StorageMode();
+    fr.imgRows = getImageHeight();
+    fr.imgBpp = getImageBpp();
+    fr.currImgRow = 0;
+    fr.spiHalves = (fr.lepton3 ? 2 : 1);
+    fr.spiScale = (80 * fr.spiHalves) / getImageWidth();
+    fr.spiRows = getSPIFrameLines();
+    fr.currSpiRow = 0;
+    fr.spiSlots = getSPIFrameSlots();
+    fr.currSpiSlot = 0;
+    fr.teleRows = (_telemetryData ? 4 : 0);
+    fr.currTeleRow = 0;
+    fr.currReadRow = 0;
+    fr.framesSkipped = 0;
+    fr.duplicatesSkipped = 0;
+    fr.frameCounter = 0;
+    fr.duplicateFrame = false;
+    fr.resynced = false;
+    fr.currRow = 0;
+    fr.skipFrame = false;
+    fr.spiPacketRead = false;
+    fr.spiPacketPending = false;
+    fr.pipelined = _transport->isAsynchronous();
+    fr.packetCRCEnabled = _packetCRCEnabled;
+    fr.imagePacketRead = false;
+
+    // Lepton 3.x frames arrive as four segments, each numbered from packet 0 again
+    fr.imgPackets = 60 * fr.spiHalves * fr.spiHalves;
+    fr.framePackets = fr.imgPackets + fr.teleRows;
+    fr.segPackets = (fr.lepton3 ? 60 + (fr.teleRows ? 1 : 0) : fr.framePackets);
+    fr.segPacketBase = 0;
+    fr.currSegment = 0;
+    fr.segmentsSkipped = 0;
+    fr.segImgRow = fr.segSpiRow = fr.segTeleRow = 0;
+
+    fr.statsEnabled = _frameStatsEnabled;
+    resetFrameStats(&fr.stats, _frameStatsThreshold);
+    fr.segStats = fr.stats;
+
+    // Software AGC histograms its region (given in module pixels) at image resolution
+    fr.softAGC = _softAGCEnabled && _softAGCData && !_agcEnabled;
+    if (fr.softAGC) {
+        uint16_t maxCol = 80 * fr.spiHalves - 1, maxRow = 60 * fr.spiHalves - 1;
+        fr.agcColBegin = min(_softAGCRegion.startCol, maxCol) / fr.spiScale;
+        fr.agcColEnd = min(_softAGCRegion.endCol, maxCol) / fr.spiScale;
+        fr.agcRowBegin = min(_softAGCRegion.startRow, maxRow) / fr.spiScale;
+        fr.agcRowEnd = min(_softAGCRegion.endRow, maxRow) / fr.spiScale;
+        resetSoftAGCHistogram();
+    }
+
+    // Downscale kernel is resolved once per frame read, dividing by shifting. With software
+    // AGC to 8bpp, 14bpp data is downscaled in place of the packet before being mapped out.
+    uint_fast8_t kernelBpp = (fr.softAGC ? 2 : fr.imgBpp);
+    fr.sumData = getSPIFrameSumData();
+    fr.pxlHalfBytes = (80 / fr.spiScale) * fr.imgBpp;
+    fr.sumHalfBytes = (80 / fr.spiScale) * 4;
+    fr.downscaleShift = (fr.spiScale == 4 ? 4 : (fr.spiScale == 2 ? 2 : 0)) + (!fr.agc8Enabled && kernelBpp == 1 ? 6 : 0);
+    // 16bpp data is left unclamped, as TLinear data (unlike 14bpp video data) spans 16 bits
+    fr.clamp = (!fr.agc8Enabled && kernelBpp == 2 ? 0xFFFF : 0x00FF);
+    if (fr.spiScale == 4)
+        fr.downscaleFunc = (kernelBpp == 2 ? downscalePacket4x4<uint16_t> : downscalePacket4x4<byte>);
+    else if (fr.spiScale == 2)
+        fr.downscaleFunc = (kernelBpp == 2 ? downscalePacket2x2<uint16_t> : downscalePacket2x2<byte>);
+    else
+        fr.downscaleFunc = (kernelBpp == 2 ? downscalePacket1x1_16bpp : downscalePacket1x1_8bpp);
+
+    _frameCRCErrors = 0;
 
-        uint16_t *spiFrame = NULL;
-        uint_fast8_t imgRows = getImageHeight();
-        uint_fast8_t currImgRow = 0;
-        uint_fast8_t spiRows = getSPIFrameLines();
-        uint_fast8_t currSpiRow = 0;
-        uint_fast8_t teleRows = (_telemetryData ? 4 : 0);
-        uint_fast8_t currTeleRow = 0;
-        uint_fast8_t currReadRow = 0;        
-        uint_fast8_t framesSkipped = 0;
-        uint_fast8_t currRow = 0;
-        bool skipFrame = false;
-        bool spiPacketRead = false;
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    _spiPacketsRead = _spiPacketMicros = 0;
+#endif
 
-        SPI.beginTransaction(_spiSettings);
+    _transport->begin(_spiSettings);
 
+    if (!_streamingEnabled || !_streamInSync) {
         _csEnableFunc(_spiCSPin);
         _csDisableFunc(_spiCSPin);
-        delayTimeout(185);
-
+        fr.waitEndTime = millis() + 185;
+        fr.phase = FrameReadPhase_Resync;
+        fr.resyncPhase = FrameReadPhase_Packet;
+        fr.resynced = true;
+    }
+    else {
         _csEnableFunc(_spiCSPin);
-        
-        while (currImgRow < imgRows || currTeleRow < teleRows) {
-            if (!spiPacketRead) {
-                spiFrame = getSPIFrameDataRow(currSpiRow);
-
-                SPI_transfer16(spiFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE16);
-                
-                skipFrame = ((spiFrame[0] & 0x0F00) == 0x0F00);
-                currRow = (spiFrame[0] & 0x00FF);
+        fr.phase = FrameReadPhase_Packet;
+    }
+
+    return true;
+}
+
+void LeptonFLiR::abortFrame() {
+    _csDisableFunc(_spiCSPin);
+    _transport->end();
+    _captureStateValid = _streamInSync = false;
+    _isReadingNextFrame = false;
+}
+
+LeptonFLiR_FrameStatus LeptonFLiR::pollFrame(int maxPackets) {
+    if (!_isReadingNextFrame) return LeptonFLiR_FrameStatus_Failed;
+
+    FrameReadState &fr = _frameRead;
+    int packetsLeft = (maxPackets > 0 ? maxPackets : -1);
+
+    while (fr.currImgRow < fr.imgRows || fr.currTeleRow < fr.teleRows) {
+        // Chip select deasserted for resync, resuming once the 185ms resync time has passed
+        if (fr.phase == FrameReadPhase_Resync) {
+            if (millis() < fr.waitEndTime)
+                return LeptonFLiR_FrameStatus_InProgress;
+
+            _csEnableFunc(_spiCSPin);
+            fr.waitEndTime = millis() + LEPFLIR_SPI_FRAME_WAIT_TIMEOUT;
+            fr.phase = fr.resyncPhase;
+            continue;
+        }
+
+        // Reading packets until sync has been reestablished
+        if (fr.phase == FrameReadPhase_Retry) {
+            if (fr.triesLeft == 0) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+                Serial.println("  LeptonFLiR::pollFrame Maximum resync retries reached. Aborting.");
+#endif
+
+                abortFrame();
+                return LeptonFLiR_FrameStatus_Failed;
             }
-            else
-                spiPacketRead = false;
 
-            if (!skipFrame && currRow == currReadRow && (
-                ((!teleRows || telemetryLocation == LEP_TELEMETRY_LOCATION_FOOTER) && currRow < 60) ||
-                (telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER && currReadRow >= teleRows))) { // Image packet
-#if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
-                Serial.println("    LeptonFLiR::readNextFrame VoSPI Image Packet:");
-                Serial.print("      ");  printSPIFrame(spiFrame);
+            if (!packetsLeft)
+                return LeptonFLiR_FrameStatus_InProgress;
+            if (packetsLeft > 0) --packetsLeft;
+
+            SPI_transferPacket(_transport, fr.spiFrame);
+
+            fr.skipFrame = ((fr.spiFrame[0] & 0x0F00) == 0x0F00);
+            fr.currRow = (fr.spiFrame[0] & 0x00FF);
+
+            if (!fr.skipFrame && fr.packetCRCEnabled && LeptonFLiRTransport::calculatePacketCRC(fr.spiFrame) != fr.spiFrame[1]) {
+                fr.skipFrame = true;
+                ++_frameCRCErrors; ++_totalCRCErrors;
+            }
+
+            if (!fr.skipFrame) {
+                if (fr.currRow == fr.currReadRow) { // Reestablished sync at position we're next expecting
+                    fr.phase = FrameReadPhase_Packet;
+                    continue;
+                }
+                else if (fr.currRow == 0) { // Reestablished sync at next frame position
+                    if ((fr.currReadRow || fr.framesSkipped) && ++fr.framesSkipped >= 5) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+                        Serial.println("  LeptonFLiR::pollFrame Maximum frame skip reached. Aborting.");
 #endif
 
-                ++currReadRow; ++currSpiRow;
+                        abortFrame();
+                        return LeptonFLiR_FrameStatus_Failed;
+                    }
+                    else if (fr.currSegment) { // Lepton 3.x segment restart, verified once packet 20 arrives
+                        fr.resynced = fr.resynced || fr.framesSkipped;
+                        if (fr.segSpiRow)
+                            restoreSPIFrameSegment();
+                        fr.currImgRow = fr.segImgRow; fr.currSpiRow = fr.segSpiRow; fr.currTeleRow = fr.segTeleRow;
+                        fr.currReadRow = 0;
+                        fr.stats = fr.segStats;
+
+                        fr.phase = FrameReadPhase_Packet;
+                        continue;
+                    }
+                    else {
+                        fr.resynced = fr.resynced || fr.framesSkipped;
+                        fr.currReadRow = fr.currImgRow = fr.currSpiRow = fr.currTeleRow = 0;
+                        resetFrameStats(&fr.stats, _frameStatsThreshold);
+                        if (fr.softAGC) resetSoftAGCHistogram();
+
+                        fr.phase = FrameReadPhase_Packet;
+                        continue;
+                    }
+                }
             }
-            else if (!skipFrame && currRow == currReadRow && teleRows &&
-                ((telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER && currReadRow < teleRows) ||
-                 (telemetryLocation == LEP_TELEMETRY_LOCATION_FOOTER && currReadRow >= 60))) { // Telemetry packet
-                if (currTeleRow == 0)
-                    memcpy(_telemetryData, spiFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE);
 
 #if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
-                Serial.print("    LeptonFLiR::readNextFrame VoSPI Telemetry(");
-                Serial.print((char)('A' + currTeleRow));
-                Serial.println(") Packet:");
-                Serial.print("      ");  printSPIFrame(spiFrame);
+            Serial.println("    LeptonFLiR::pollFrame VoSPI Discard Retry Packet:");
+            Serial.print("      ");  printSPIFrame(fr.spiFrame);
 #endif
 
-                ++currReadRow; ++currTeleRow;
+            if (!fr.waitingForFrame || !fr.skipFrame || millis() >= fr.waitEndTime)
+                --fr.triesLeft;
+            continue;
+        }
+
+        if (!fr.spiPacketRead) {
+            fr.spiFrame = getSPIFrameDataRow(fr.currSpiSlot);
+
+            if (!fr.spiPacketPending) {
+                if (!packetsLeft)
+                    return LeptonFLiR_FrameStatus_InProgress;
+                if (packetsLeft > 0) --packetsLeft;
+
+                SPI_submitPacket(_transport, fr.spiFrame);
+            }
+            SPI_waitPacket(_transport);
+            fr.spiPacketPending = false;
+
+            fr.skipFrame = ((fr.spiFrame[0] & 0x0F00) == 0x0F00);
+            fr.currRow = (fr.spiFrame[0] & 0x00FF);
+
+            if (!fr.skipFrame && fr.packetCRCEnabled && LeptonFLiRTransport::calculatePacketCRC(fr.spiFrame) != fr.spiFrame[1]) {
+                fr.skipFrame = true;
+                ++_frameCRCErrors; ++_totalCRCErrors;
             }
-            else if (!skipFrame && currRow < currReadRow) { // Ignore packet
+        }
+        else
+            fr.spiPacketRead = false;
+
+        uint_fast16_t framePacket = fr.segPacketBase + fr.currReadRow;
+
+        if (!fr.skipFrame && fr.currRow == fr.currReadRow && (
+            ((!fr.teleRows || fr.telemetryLocation == LEP_TELEMETRY_LOCATION_FOOTER) && framePacket < fr.imgPackets) ||
+            (fr.telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER && framePacket >= fr.teleRows))) { // Image packet
 #if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
-                Serial.println("    LeptonFLiR::readNextFrame VoSPI Ignore Packet:");
-                Serial.print("      ");  printSPIFrame(spiFrame);
+            Serial.println("    LeptonFLiR::pollFrame VoSPI Image Packet:");
+            Serial.print("      ");  printSPIFrame(fr.spiFrame);
 #endif
+
+            // Next packet is received into the other packet buffer, if there is one
+            ++fr.currReadRow;
+            fr.imagePacketRead = true;
+            if (fr.spiSlots > 1)
+                fr.currSpiSlot = (fr.spiFrame == getSPIFrameDataRow(0) ? 1 : 0);
+        }
+        else if (!fr.skipFrame && fr.currRow == fr.currReadRow && fr.teleRows &&
+            ((fr.telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER && framePacket < fr.teleRows) ||
+             (fr.telemetryLocation == LEP_TELEMETRY_LOCATION_FOOTER && framePacket >= fr.imgPackets))) { // Telemetry packet
+            if (fr.currTeleRow == 0) {
+                memcpy(getTelemetryBuffer(_backBuffer), fr.spiFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE);
+
+                // Header telemetry arrives ahead of all image rows, early enough to skip duplicates
+                fr.frameCounter = ((uint32_t)fr.spiFrame[2 + 20] << 16) | (uint32_t)fr.spiFrame[2 + 21];
+                fr.duplicateFrame = _uniqueFramesOnly && fr.telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER &&
+                    _lastFrameCounterValid && fr.frameCounter == _lastFrameCounter;
             }
-            else { // Discard packet
+            if (_telemetryPacketFunc)
+                _telemetryPacketFunc(fr.currTeleRow, (byte *)fr.spiFrame);
+
 #if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
-                Serial.println("    LeptonFLiR::readNextFrame VoSPI Discard Packet:");
-                Serial.print("      ");  printSPIFrame(spiFrame);
+            Serial.print("    LeptonFLiR::pollFrame VoSPI Telemetry(");
+            Serial.print((char)('A' + fr.currTeleRow));
+            Serial.println(") Packet:");
+            Serial.print("      ");  printSPIFrame(fr.spiFrame);
 #endif
 
-                if (skipFrame && (currReadRow || framesSkipped)) {
-                    _csDisableFunc(_spiCSPin);
-                    delayTimeout(185);
-                    _csEnableFunc(_spiCSPin);
-                }
+            ++fr.currReadRow; ++fr.currTeleRow;
+        }
+        else if (!fr.skipFrame && fr.currRow < fr.currReadRow) { // Ignore packet
+#if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
+            Serial.println("    LeptonFLiR::pollFrame VoSPI Ignore Packet:");
+            Serial.print("      ");  printSPIFrame(fr.spiFrame);
+#endif
+        }
+        else { // Discard packet
+#if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
+            Serial.println("    LeptonFLiR::pollFrame VoSPI Discard Packet:");
+            Serial.print("      ");  printSPIFrame(fr.spiFrame);
+#endif
+
+            // While streaming, discard packets ahead of the first packet are the camera
+            // idling between frames, so those are waited out on a timeout instead. The
+            // same goes for the camera idling between Lepton 3.x segments, and after a
+            // duplicate frame has been skipped.
+            fr.waitingForFrame = (_streamingEnabled || fr.currSegment || fr.duplicatesSkipped) && !fr.currReadRow && !fr.framesSkipped;
+            fr.waitEndTime = millis() + LEPFLIR_SPI_FRAME_WAIT_TIMEOUT;
+            fr.triesLeft = 120;
+            fr.spiPacketRead = true;
+            fr.phase = FrameReadPhase_Retry;
+
+            if (fr.skipFrame && (fr.currReadRow || fr.framesSkipped)) {
+                _csDisableFunc(_spiCSPin);
+                fr.waitEndTime = millis() + 185;
+                fr.phase = FrameReadPhase_Resync;
+                fr.resyncPhase = FrameReadPhase_Retry;
+                fr.resynced = true;
+            }
 
-                uint_fast8_t triesLeft = 120;
-                spiPacketRead = true;
-                
-                while (triesLeft > 0) {
-                    SPI_transfer16(spiFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE16);
-                    
-                    skipFrame = ((spiFrame[0] & 0x0F00) == 0x0F00);
-                    currRow = (spiFrame[0] & 0x00FF);
-
-                    if (!skipFrame) {
-                        if (currRow == currReadRow) { // Reestablished sync at position we're next expecting
-                            break;
-                        }
-                        else if (currRow == 0) { // Reestablished sync at next frame position
-                            if ((currReadRow || framesSkipped) && ++framesSkipped >= 5) {
-#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-                                Serial.println("  LeptonFLiR::readNextFrame Maximum frame skip reached. Aborting.");
-#endif
-
-                                _csDisableFunc(_spiCSPin);
-                                SPI.endTransaction();
-                                _isReadingNextFrame = false;
-                                return false;
-                            }
-                            else {
-                                currReadRow = currImgRow = currSpiRow = currTeleRow = 0;
-
-                                uint16_t* prevSPIFrame = spiFrame;
-                                spiFrame = getSPIFrameDataRow(currSpiRow);
-                                if (spiFrame != prevSPIFrame)
-                                    memcpy(spiFrame, prevSPIFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE);
-
-                                break;
-                            }
-                        }
-                    }
+            continue;
+        }
 
+        // Lepton 3.x segment number is carried in packet 20, by which point the segment's
+        // packets have already been written out to where the expected segment goes
+        if (fr.lepton3 && fr.currRow == 20 && fr.currReadRow == 21 && !fr.spiPacketRead) {
+            uint_fast8_t segment = (fr.spiFrame[0] >> 12) & 0x07;
+
+            if (segment != fr.currSegment + 1) { // Rewind to segment start, skipping its remaining packets
 #if defined(LEPFLIR_ENABLE_DEBUG_OUTPUT) && defined(LEPFLIR_ENABLE_FRAME_PACKET_DEBUG_OUTPUT)
-                    Serial.println("    LeptonFLiR::readNextFrame VoSPI Discard Retry Packet:");
-                    Serial.print("      ");  printSPIFrame(spiFrame);
+                Serial.print("    LeptonFLiR::pollFrame VoSPI Segment Discarded, Expected: ");
+                Serial.print(fr.currSegment + 1);
+                Serial.print(", Received: ");
+                Serial.println(segment);
+#endif
+
+                if (fr.segSpiRow)
+                    restoreSPIFrameSegment();
+                fr.currImgRow = fr.segImgRow; fr.currSpiRow = fr.segSpiRow; fr.currTeleRow = fr.segTeleRow;
+                fr.currReadRow = 0;
+                fr.stats = fr.segStats;
+                fr.imagePacketRead = false;
+
+                if (segment && fr.currSegment) { // Out of order segment (e.g. one got lost), restart at next frame
+                    if (++fr.framesSkipped >= 5) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+                        Serial.println("  LeptonFLiR::pollFrame Maximum frame skip reached. Aborting.");
 #endif
 
-                    --triesLeft;
+                        abortFrame();
+                        return LeptonFLiR_FrameStatus_Failed;
+                    }
+
+                    fr.resynced = true;
+                    fr.currSegment = 0; fr.segPacketBase = 0;
+                    fr.currImgRow = fr.currSpiRow = fr.currTeleRow = 0;
+                    resetFrameStats(&fr.stats, _frameStatsThreshold);
+                    if (fr.softAGC) resetSoftAGCHistogram();
+                    fr.segImgRow = fr.segSpiRow = fr.segTeleRow = 0;
+                    fr.segStats = fr.stats;
                 }
 
-                if (triesLeft == 0) {
+                if (++fr.segmentsSkipped >= LEPFLIR_SPI_MAX_SEGMENT_SKIPS) {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-                    Serial.println("  LeptonFLiR::readNextFrame Maximum resync retries reached. Aborting.");
+                    Serial.println("  LeptonFLiR::pollFrame Maximum segment skip reached. Aborting.");
 #endif
 
-                    _csDisableFunc(_spiCSPin);
-                    SPI.endTransaction();
-                    _isReadingNextFrame = false;
-                    return false;
+                    abortFrame();
+                    return LeptonFLiR_FrameStatus_Failed;
                 }
             }
+        }
 
-            // Write out to frame
-            if (currSpiRow == spiRows) {
-                if (_storageMode == LeptonFLiR_ImageStorageMode_80x60_16bpp) {
-                    memcpy(_getImageDataRow(currImgRow), getSPIFrameDataRow(0) + 2, LEPFLIR_SPI_FRAME_PACKET_SIZE - 4);
-                }
-                else if (_storageMode == LeptonFLiR_ImageStorageMode_80x60_8bpp && agc8Enabled) {
-                    byte *pxlData = _getImageDataRow(currImgRow);
-                    spiFrame = getSPIFrameDataRow(0) + 2;
-                    uint_fast8_t size = LEPFLIR_SPI_FRAME_PACKET_SIZE16 - 2;
-                    while (size--)
-                        *pxlData++ = (byte)constrain(*spiFrame++, 0, 0x00FF);
-                }
-                else {
-                    spiFrame = getSPIFrameDataRow(0) + 2;
-                    byte *pxlData = _getImageDataRow(currImgRow);
+        // Overlap reception of the next packet with write out of the current one
+        if (fr.pipelined && !fr.spiPacketRead && packetsLeft && fr.segPacketBase + fr.currReadRow < fr.framePackets) {
+            if (packetsLeft > 0) --packetsLeft;
 
-                    uint_fast8_t imgWidth = getImageWidth();
-                    uint_fast8_t imgBpp = getImageBpp();
-                    uint_fast8_t spiPitch16 = roundUpVal16(LEPFLIR_SPI_FRAME_PACKET_SIZE) / 2;
+            SPI_submitPacket(_transport, getSPIFrameDataRow(fr.currSpiSlot));
+            fr.spiPacketPending = true;
+        }
 
-                    uint_fast32_t divisor = (spiRows * spiRows) * (!agc8Enabled && imgBpp == 1 ? 64 : 1);
-                    uint_fast32_t clamp = (!agc8Enabled && imgBpp == 2 ? 0x3FFF : 0x00FF);
+        // Write out packet to frame as it arrives, skipped for duplicate frames
+        if (fr.imagePacketRead) {
+            byte *rowData = (_imageRowData ? roundUpPtr16(_imageRowData) : _getImageDataRow(fr.currImgRow));
+            fr.imagePacketRead = false;
 
-                    while (imgWidth-- > 0) {
-                        uint_fast32_t total = 0;
+            if (!fr.duplicateFrame) {
+                // Lepton 3.x lines are split over two packets, each covering half of the row
+                uint_fast8_t half = fr.currSpiRow % fr.spiHalves;
+                uint_fast8_t spiRow = fr.currSpiRow / fr.spiHalves;
+                byte *pxlData = rowData + (half * fr.pxlHalfBytes);
 
-                        uint_fast8_t y = spiRows;
-                        uint16_t *spiYFrame = spiFrame;
-                        while (y-- > 0) {
+                if (!fr.softAGC)
+                    fr.downscaleFunc(pxlData, fr.sumData + (half * fr.sumHalfBytes), fr.spiFrame + 2, spiRow, fr.downscaleShift, fr.clamp);
+                else {
+                    uint_fast8_t imgCols = 80 / fr.spiScale;
+                    uint16_t *valueData = (fr.imgBpp == 2 ? (uint16_t *)pxlData : fr.spiFrame + 2);
 
-                            uint_fast8_t x = spiRows;
-                            uint16_t *spiXFrame = spiYFrame;
-                            while (x-- > 0)
-                                total += *spiXFrame++;
+                    if (fr.imgBpp == 2 || fr.spiScale > 1)
+                        fr.downscaleFunc((byte *)valueData, fr.sumData + (half * fr.sumHalfBytes), fr.spiFrame + 2, spiRow, fr.downscaleShift, fr.clamp);
+                    if (spiRow == fr.spiScale - 1)
+                        softAGCPacket(valueData, (fr.imgBpp == 1 ? pxlData : NULL), half * imgCols, imgCols);
+                }
+            }
 
-                            spiYFrame += spiPitch16;
-                        }
+            if (++fr.currSpiRow == fr.spiRows) {
+                if (fr.statsEnabled && !fr.duplicateFrame) {
+                    uint_fast8_t imgWidth = (80 * fr.spiHalves) / fr.spiScale;
+                    if (fr.imgBpp == 2)
+                        accumulateFrameStats<uint16_t>(&fr.stats, rowData, fr.currImgRow, imgWidth);
+                    else
+                        accumulateFrameStats<byte>(&fr.stats, rowData, fr.currImgRow, imgWidth);
+                }
 
-                        total /= divisor;
+                if (_imageRowData && !fr.duplicateFrame)
+                    _imageRowFunc(fr.currImgRow, rowData);
 
-                        if (imgBpp == 2)
-                            *((uint16_t *)pxlData) = (uint16_t)constrain(total, 0, clamp);
-                        else
-                            *((byte *)pxlData) = (byte)constrain(total, 0, clamp);
-                        pxlData += imgBpp;
-                        spiFrame += spiRows;
-                    }
-                }
+                ++fr.currImgRow; fr.currSpiRow = 0;
+            }
+        }
+
+        // Move on to next Lepton 3.x segment, saving where it starts in case it gets discarded
+        if (fr.lepton3 && fr.currReadRow == fr.segPackets) {
+            ++fr.currSegment;
+            fr.segPacketBase += fr.segPackets;
+            fr.currReadRow = 0;
+
+            fr.segImgRow = fr.currImgRow; fr.segSpiRow = fr.currSpiRow; fr.segTeleRow = fr.currTeleRow;
+            fr.segStats = fr.stats;
+            if (fr.segSpiRow)
+                saveSPIFrameSegment();
+        }
+
+        // Duplicate frame fully read, restart with the next frame in its place
+        if (fr.duplicateFrame && fr.currImgRow >= fr.imgRows && fr.currTeleRow >= fr.teleRows) {
+            if (++fr.duplicatesSkipped >= LEPFLIR_SPI_MAX_DUPLICATE_SKIPS) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+                Serial.println("  LeptonFLiR::pollFrame Maximum duplicate frame skip reached. Aborting.");
+#endif
 
-                ++currImgRow; currSpiRow = 0;
+                abortFrame();
+                return LeptonFLiR_FrameStatus_Failed;
             }
+
+            ++_duplicateFramesSkipped;
+            fr.duplicateFrame = false;
+            fr.currSegment = 0; fr.segPacketBase = 0;
+            fr.currReadRow = fr.currImgRow = fr.currSpiRow = fr.currTeleRow = 0;
+            resetFrameStats(&fr.stats, _frameStatsThreshold);
+            if (fr.softAGC) resetSoftAGCHistogram();
+            fr.segImgRow = fr.segSpiRow = fr.segTeleRow = 0;
+            fr.segStats = fr.stats;
         }
+    }
+
+    if (_streamingEnabled) {
+        _csDisableFunc(_spiCSPin);
+        _streamSyncedFrames = fr.resynced ? 0 : _streamSyncedFrames + 1;
+        _streamInSync = true;
+    }
 
-        SPI.endTransaction();
+    _transport->end();
 
-        _isReadingNextFrame = false;
+    if (fr.teleRows && fr.telemetryLocation == LEP_TELEMETRY_LOCATION_HEADER) {
+        _lastFrameCounter = fr.frameCounter;
+        _lastFrameCounterValid = true;
     }
 
-    return true;
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.print("  LeptonFLiR::pollFrame SPI packets read: ");
+    Serial.print(_spiPacketsRead);
+    Serial.print(", avg blocked time: ");
+    Serial.print(_spiPacketsRead ? _spiPacketMicros / (float)_spiPacketsRead : 0.0f);
+    Serial.print("us");
+    if (fr.packetCRCEnabled) {
+        Serial.print(", CRC errors: ");
+        Serial.print(_frameCRCErrors);
+    }
+    if (fr.duplicatesSkipped) {
+        Serial.print(", duplicates skipped: ");
+        Serial.print(fr.duplicatesSkipped);
+    }
+    Serial.println("");
+#endif
+
+    if (fr.statsEnabled) {
+        fr.stats.mean = (uint16_t)(fr.stats.sum / ((uint32_t)fr.imgRows * ((80 * fr.spiHalves) / fr.spiScale)));
+        _frameStats[_backBuffer] = fr.stats;
+    }
+
+    if (fr.softAGC)
+        updateSoftAGCLUT();
+
+    swapFrameBuffers();
+
+    _isReadingNextFrame = false;
+
+    return LeptonFLiR_FrameStatus_FrameReady;
 }
 
 void LeptonFLiR::agc_setAGCEnabled(bool enabled) {
@@ -661,6 +1867,11 @@ void LeptonFLiR::agc_setAGCEnabled(bool enabled) {
 #endif
 
     sendCommand(cmdCode(LEP_CID_AGC_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)enabled);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _agcEnabled = enabled;
+    else
+        _captureStateValid = false;
 }
 
 bool LeptonFLiR::agc_getAGCEnabled() {
@@ -670,6 +1881,10 @@ bool LeptonFLiR::agc_getAGCEnabled() {
 
     uint32_t enabled;
     receiveCommand(cmdCode(LEP_CID_AGC_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &enabled);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _agcEnabled = enabled;
+
     return enabled;
 }
 
@@ -697,6 +1912,11 @@ void LeptonFLiR::agc_setHEQScaleFactor(LEP_AGC_HEQ_SCALE_FACTOR factor) {
 #endif
 
     sendCommand(cmdCode(LEP_CID_AGC_HEQ_SCALE_FACTOR, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)factor);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _heqScaleFactor = factor;
+    else
+        _captureStateValid = false;
 }
 
 LEP_AGC_HEQ_SCALE_FACTOR LeptonFLiR::agc_getHEQScaleFactor() {
@@ -706,6 +1926,10 @@ LEP_AGC_HEQ_SCALE_FACTOR LeptonFLiR::agc_getHEQScaleFactor() {
 
     uint32_t factor;
     receiveCommand(cmdCode(LEP_CID_AGC_HEQ_SCALE_FACTOR, LEP_I2C_COMMAND_TYPE_GET), &factor);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _heqScaleFactor = (LEP_AGC_HEQ_SCALE_FACTOR)factor;
+
     return (LEP_AGC_HEQ_SCALE_FACTOR)factor;
 }
 
@@ -803,21 +2027,21 @@ void LeptonFLiR::sys_setTelemetryEnabled(bool enabled) {
     sendCommand(cmdCode(LEP_CID_SYS_TELEMETRY_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)enabled);
 
     if (!_lastI2CError && !_lastLepResult) {
-        if (enabled && !_telemetryData) {
-            _telemetryData = (byte *)malloc(LEPFLIR_SPI_FRAME_PACKET_SIZE);
+        _telemetryEnabled = enabled;
 
-            if (_telemetryData)
-                _telemetryData[0] = _telemetryData[1] = 0xFF; // initialize as discard packet
+        if (enabled && !_telemetryData) {
+            _telemetryData = allocTelemetryData();
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
             if (!_telemetryData)
                 Serial.println("  LeptonFLiR::sys_setTelemetryEnabled Failure allocating telemetryData.");
 #endif
         }
         else if (!enabled && _telemetryData) {
-            free(_telemetryData);
-            _telemetryData = NULL;
+            freeTelemetryData();
         }
     }
+    else
+        _captureStateValid = false;
 }
 
 bool LeptonFLiR::sys_getTelemetryEnabled() {
@@ -829,19 +2053,17 @@ bool LeptonFLiR::sys_getTelemetryEnabled() {
     receiveCommand(cmdCode(LEP_CID_SYS_TELEMETRY_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &enabled);
 
     if (!_lastI2CError && !_lastLepResult) {
-        if (enabled && !_telemetryData) {
-            _telemetryData = (byte *)malloc(LEPFLIR_SPI_FRAME_PACKET_SIZE);
+        _telemetryEnabled = enabled;
 
-            if (_telemetryData)
-                _telemetryData[0] = _telemetryData[1] = 0xFF; // initialize as discard packet
+        if (enabled && !_telemetryData) {
+            _telemetryData = allocTelemetryData();
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
             if (!_telemetryData)
                 Serial.println("  LeptonFLiR::sys_getTelemetryEnabled Failure allocating telemetryData.");
 #endif
         }
         else if (!enabled && _telemetryData) {
-            free(_telemetryData);
-            _telemetryData = NULL;
+            freeTelemetryData();
         }
     }
 
@@ -923,9 +2145,70 @@ bool LeptonFLiR::vid_getFreezeEnabled() {
     Serial.println("LeptonFLiR::vid_getFreezeEnabled");
 #endif
 
-    uint32_t enabled;
-    receiveCommand(cmdCode(LEP_CID_VID_FREEZE_ENABLE, LEP_I2C_COMMAND_TYPE_GET), &enabled);
-    return enabled;
+    uint32_t enabled;
+    receiveCommand(cmdCode(LEP_CID_VID_FREEZE_ENABLE, LEP_I2C_COMMAND_TYPE_GET), &enabled);
+    return enabled;
+}
+
+void LeptonFLiR::rad_setRadiometryEnabled(bool enabled) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_setRadiometryEnabled");
+#endif
+
+    sendCommand(cmdCode(LEP_CID_RAD_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)enabled);
+}
+
+bool LeptonFLiR::rad_getRadiometryEnabled() {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getRadiometryEnabled");
+#endif
+
+    uint32_t enabled;
+    receiveCommand(cmdCode(LEP_CID_RAD_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &enabled);
+    return enabled;
+}
+
+void LeptonFLiR::rad_setTLinearEnabled(bool enabled) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_setTLinearEnabled");
+#endif
+
+    sendCommand(cmdCode(LEP_CID_RAD_TLINEAR_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)enabled);
+}
+
+bool LeptonFLiR::rad_getTLinearEnabled() {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getTLinearEnabled");
+#endif
+
+    uint32_t enabled;
+    receiveCommand(cmdCode(LEP_CID_RAD_TLINEAR_ENABLE_STATE, LEP_I2C_COMMAND_TYPE_GET), &enabled);
+    return enabled;
+}
+
+void LeptonFLiR::rad_setTLinearResolution(LEP_RAD_TLINEAR_RESOLUTION resolution) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_setTLinearResolution");
+#endif
+
+    sendCommand(cmdCode(LEP_CID_RAD_TLINEAR_RESOLUTION, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)resolution);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _tlinearResolution = resolution;
+}
+
+LEP_RAD_TLINEAR_RESOLUTION LeptonFLiR::rad_getTLinearResolution() {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getTLinearResolution");
+#endif
+
+    uint32_t resolution;
+    receiveCommand(cmdCode(LEP_CID_RAD_TLINEAR_RESOLUTION, LEP_I2C_COMMAND_TYPE_GET), &resolution);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _tlinearResolution = (LEP_RAD_TLINEAR_RESOLUTION)resolution;
+
+    return (LEP_RAD_TLINEAR_RESOLUTION)resolution;
 }
 
 #ifndef LEPFLIR_EXCLUDE_EXT_I2C_FUNCS
@@ -1208,6 +2491,11 @@ void LeptonFLiR::sys_setTelemetryLocation(LEP_SYS_TELEMETRY_LOCATION location) {
 #endif
 
     sendCommand(cmdCode(LEP_CID_SYS_TELEMETRY_LOCATION, LEP_I2C_COMMAND_TYPE_SET), (uint32_t)location);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _telemetryLocation = location;
+    else
+        _captureStateValid = false;
 }
 
 LEP_SYS_TELEMETRY_LOCATION LeptonFLiR::sys_getTelemetryLocation() {
@@ -1217,6 +2505,10 @@ LEP_SYS_TELEMETRY_LOCATION LeptonFLiR::sys_getTelemetryLocation() {
 
     uint32_t location;
     receiveCommand(cmdCode(LEP_CID_SYS_TELEMETRY_LOCATION, LEP_I2C_COMMAND_TYPE_GET), &location);
+
+    if (!_lastI2CError && !_lastLepResult)
+        _telemetryLocation = (LEP_SYS_TELEMETRY_LOCATION)location;
+
     return (LEP_SYS_TELEMETRY_LOCATION)location;
 }
 
@@ -1425,123 +2717,587 @@ void LeptonFLiR::vid_setGamma(uint32_t gamma) {
     Serial.println("LeptonFLiR::vid_setGamma");
 #endif
 
-    sendCommand(cmdCode(LEP_CID_VID_GAMMA_SELECT, LEP_I2C_COMMAND_TYPE_SET), gamma);
+    sendCommand(cmdCode(LEP_CID_VID_GAMMA_SELECT, LEP_I2C_COMMAND_TYPE_SET), gamma);
+}
+
+uint32_t LeptonFLiR::vid_getGamma() {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::vid_getGamma");
+#endif
+
+    uint32_t gamma;
+    receiveCommand(cmdCode(LEP_CID_VID_GAMMA_SELECT, LEP_I2C_COMMAND_TYPE_GET), &gamma);
+    return gamma;
+}
+
+void LeptonFLiR::rad_setSpotmeterRegion(LEP_RAD_ROI *region) {
+    if (!region) return;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_setSpotmeterRegion");
+#endif
+
+    sendCommand(cmdCode(LEP_CID_RAD_SPOTMETER_ROI, LEP_I2C_COMMAND_TYPE_SET), (uint16_t *)region, sizeof(LEP_RAD_ROI) / 2);
+}
+
+void LeptonFLiR::rad_getSpotmeterRegion(LEP_RAD_ROI *region) {
+    if (!region) return;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getSpotmeterRegion");
+#endif
+
+    receiveCommand(cmdCode(LEP_CID_RAD_SPOTMETER_ROI, LEP_I2C_COMMAND_TYPE_GET), (uint16_t *)region, sizeof(LEP_RAD_ROI) / 2);
+}
+
+void LeptonFLiR::rad_getSpotmeterValue(LEP_RAD_SPOTMETER_OBJ_KELVIN *value) {
+    if (!value) return;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getSpotmeterValue");
+#endif
+
+    receiveCommand(cmdCode(LEP_CID_RAD_SPOTMETER_OBJ_KELVIN, LEP_I2C_COMMAND_TYPE_GET), (uint16_t *)value, sizeof(LEP_RAD_SPOTMETER_OBJ_KELVIN) / 2);
+}
+
+float LeptonFLiR::rad_getSpotmeterTemperature() {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getSpotmeterTemperature");
+#endif
+
+    LEP_RAD_SPOTMETER_OBJ_KELVIN value;
+    receiveCommand(cmdCode(LEP_CID_RAD_SPOTMETER_OBJ_KELVIN, LEP_I2C_COMMAND_TYPE_GET), (uint16_t *)&value, sizeof(LEP_RAD_SPOTMETER_OBJ_KELVIN) / 2);
+    uint32_t kelvin100 = value.radSpotmeterValue * (uint32_t)(_tlinearResolution == LEP_RAD_RESOLUTION_0_1 ? 10 : 1);
+    return kelvin100ToTemperature((uint16_t)min(kelvin100, (uint32_t)0xFFFF));
+}
+
+void LeptonFLiR::rad_setFluxLinearParams(LEP_RAD_FLUX_LINEAR_PARAMS *params) {
+    if (!params) return;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_setFluxLinearParams");
+#endif
+
+    sendCommand(cmdCode(LEP_CID_RAD_FLUX_LINEAR_PARAMS, LEP_I2C_COMMAND_TYPE_SET), (uint16_t *)params, sizeof(LEP_RAD_FLUX_LINEAR_PARAMS) / 2);
+}
+
+void LeptonFLiR::rad_getFluxLinearParams(LEP_RAD_FLUX_LINEAR_PARAMS *params) {
+    if (!params) return;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::rad_getFluxLinearParams");
+#endif
+
+    receiveCommand(cmdCode(LEP_CID_RAD_FLUX_LINEAR_PARAMS, LEP_I2C_COMMAND_TYPE_GET), (uint16_t *)params, sizeof(LEP_RAD_FLUX_LINEAR_PARAMS) / 2);
+}
+
+#endif
+
+static inline void byteToHexString(byte value, char *buffer) {
+    byte highNibble = value / 16;
+    byte lowNibble = value % 16;
+    if (highNibble < 10) buffer[0] = '0' + highNibble;
+    else buffer[0] = 'A' + (highNibble - 10);
+    if (lowNibble < 10) buffer[1] = '0' + lowNibble;
+    else buffer[1] = 'A' + (lowNibble - 10);
+}
+
+void wordsToHexString(uint16_t *dataWords, int dataLength, char *buffer, int maxLength) {
+    bool insertColons = maxLength >= (dataLength * 4) + (dataLength - 1);
+
+    while (dataLength-- > 0 && maxLength > 3) {
+        if (maxLength > 3) {
+            byteToHexString(highByte(*dataWords), buffer);
+            buffer += 2; maxLength -= 2;
+            byteToHexString(lowByte(*dataWords), buffer);
+            buffer += 2; maxLength -= 2;
+            ++dataWords;
+        }
+
+        if (dataLength > 0 && insertColons && maxLength-- > 0)
+            *buffer++ = ':';
+    }
+
+    if (maxLength-- > 0)
+        *buffer++ = '\0';
+}
+
+float kelvin100ToCelsius(uint16_t kelvin100) {
+    float kelvin = (kelvin100 / 100) + ((kelvin100 % 100) * 0.01f);
+    return kelvin - 273.15f;
+}
+
+float kelvin100ToFahrenheit(uint16_t kelvin100) {
+    float kelvin = (kelvin100 / 100) + ((kelvin100 % 100) * 0.01f);
+    return roundf((((kelvin * 9.0f) / 5.0f) - 459.67f) * 100.0f) / 100.0f;
+}
+
+float kelvin100ToKelvin(uint16_t kelvin100) {
+    return (kelvin100 / 100) + ((kelvin100 % 100) * 0.01f);
+}
+
+uint16_t celsiusToKelvin100(float celsius) {
+    float kelvin = celsius + 273.15f;
+    return (uint16_t)roundf(kelvin * 100.0f);
+}
+
+uint16_t fahrenheitToKelvin100(float fahrenheit) {
+    float kelvin = ((fahrenheit + 459.67f) * 5.0f) / 9.0f;
+    return (uint16_t)roundf(kelvin * 100.0f);
+}
+
+uint16_t kelvinToKelvin100(float kelvin) {
+    return (uint16_t)roundf(kelvin * 100.0f);
+}
+
+int32_t kelvin100ToCelsius100(uint16_t kelvin100) {
+    return (int32_t)kelvin100 - 27315;
+}
+
+int32_t kelvin100ToFahrenheit100(uint16_t kelvin100) {
+    return ((((int32_t)kelvin100 * 18) + 5) / 10) - 45967;
+}
+
+uint16_t celsius100ToKelvin100(int32_t celsius100) {
+    return (uint16_t)constrain(celsius100 + 27315, (int32_t)0, (int32_t)0xFFFF);
+}
+
+uint16_t fahrenheit100ToKelvin100(int32_t fahrenheit100) {
+    int32_t kelvin100 = (fahrenheit100 + 45967) * 5;
+    kelvin100 = (kelvin100 >= 0 ? ((kelvin100 * 2) + 9) / 18 : 0);
+    return (uint16_t)constrain(kelvin100, (int32_t)0, (int32_t)0xFFFF);
+}
+
+float LeptonFLiR::kelvin100ToTemperature(uint16_t kelvin100) {
+    switch (_tempMode) {
+        case LeptonFLiR_TemperatureMode_Celsius:
+            return kelvin100ToCelsius(kelvin100);
+        case LeptonFLiR_TemperatureMode_Fahrenheit:
+            return kelvin100ToFahrenheit(kelvin100);
+        case LeptonFLiR_TemperatureMode_Kelvin:
+            return kelvin100ToKelvin(kelvin100);
+        default:
+            return 0;
+    }
+}
+
+uint16_t LeptonFLiR::temperatureToKelvin100(float temperature) {
+    switch (_tempMode) {
+        case LeptonFLiR_TemperatureMode_Celsius:
+            return celsiusToKelvin100(temperature);
+        case LeptonFLiR_TemperatureMode_Fahrenheit:
+            return fahrenheitToKelvin100(temperature);
+        case LeptonFLiR_TemperatureMode_Kelvin:
+            return kelvinToKelvin100(temperature);
+        default:
+            return 0;
+    }
+}
+
+int32_t LeptonFLiR::kelvin100ToTemperature100(uint16_t kelvin100) {
+    switch (_tempMode) {
+        case LeptonFLiR_TemperatureMode_Celsius:
+            return kelvin100ToCelsius100(kelvin100);
+        case LeptonFLiR_TemperatureMode_Fahrenheit:
+            return kelvin100ToFahrenheit100(kelvin100);
+        case LeptonFLiR_TemperatureMode_Kelvin:
+            return kelvin100;
+        default:
+            return 0;
+    }
+}
+
+uint16_t LeptonFLiR::temperature100ToKelvin100(int32_t temperature100) {
+    switch (_tempMode) {
+        case LeptonFLiR_TemperatureMode_Celsius:
+            return celsius100ToKelvin100(temperature100);
+        case LeptonFLiR_TemperatureMode_Fahrenheit:
+            return fahrenheit100ToKelvin100(temperature100);
+        case LeptonFLiR_TemperatureMode_Kelvin:
+            return (uint16_t)constrain(temperature100, (int32_t)0, (int32_t)0xFFFF);
+        default:
+            return 0;
+    }
+}
+
+// Resolves the temperature mode into a linear mapping, with the multiplier kept under 16
+// bits so that the product with kelvin x 100 values stays within 32 bits
+void LeptonFLiR::getTemperatureMapping(TemperatureMapping *mapping, byte rawScale) {
+    uint32_t num = rawScale, den = 1;
+    mapping->offset = 0;
+
+    switch (_tempMode) {
+        case LeptonFLiR_TemperatureMode_Celsius:
+            mapping->offset = -27315;
+            break;
+        case LeptonFLiR_TemperatureMode_Fahrenheit:
+            num *= 9; den = 5;
+            mapping->offset = -45967;
+            break;
+        default:
+            break;
+    }
+
+    mapping->shift = 0;
+    while (mapping->shift < 16 && ((num << (mapping->shift + 1)) / den) < 0x10000UL)
+        ++mapping->shift;
+    mapping->mult = ((num << mapping->shift) + (den / 2)) / den;
+}
+
+void LeptonFLiR::mapTemperature100(uint16_t *rawData, int32_t *temperature100Data, int count, TemperatureMapping *mapping) {
+    if (mapping->mult == (1UL << mapping->shift)) {
+        while (count-- > 0)
+            *temperature100Data++ = (int32_t)*rawData++ + mapping->offset;
+    }
+    else {
+        uint32_t round = (mapping->shift ? 1UL << (mapping->shift - 1) : 0);
+        while (count-- > 0)
+            *temperature100Data++ = (int32_t)((((uint32_t)*rawData++ * mapping->mult) + round) >> mapping->shift) + mapping->offset;
+    }
+}
+
+void LeptonFLiR::kelvin100ToTemperature100(uint16_t *kelvin100Data, int32_t *temperature100Data, int count) {
+    if (!kelvin100Data || !temperature100Data) return;
+    TemperatureMapping mapping;
+    getTemperatureMapping(&mapping);
+    mapTemperature100(kelvin100Data, temperature100Data, count, &mapping);
+}
+
+void LeptonFLiR::imageRowToTemperature100(byte *rowData, int32_t *temperature100Data) {
+    if (!rowData || !temperature100Data || getImageBpp() != 2) return;
+    TemperatureMapping mapping;
+    getTemperatureMapping(&mapping, _tlinearResolution == LEP_RAD_RESOLUTION_0_1 ? 10 : 1);
+    mapTemperature100((uint16_t *)rowData, temperature100Data, getImageWidth(), &mapping);
+}
+
+void LeptonFLiR::imageToTemperature100(int32_t *temperature100Data) {
+    byte *imageData = getImageData();
+    if (!imageData || !temperature100Data || getImageBpp() != 2) return;
+    int width = getImageWidth(), height = getImageHeight(), pitch = getImagePitch();
+    TemperatureMapping mapping;
+    getTemperatureMapping(&mapping, _tlinearResolution == LEP_RAD_RESOLUTION_0_1 ? 10 : 1);
+
+    for (int row = 0; row < height; ++row, imageData += pitch, temperature100Data += width)
+        mapTemperature100((uint16_t *)imageData, temperature100Data, width, &mapping);
+}
+
+const char *LeptonFLiR::getTemperatureSymbol() {
+    switch (_tempMode) {
+        case LeptonFLiR_TemperatureMode_Celsius:
+            return "C";
+        case LeptonFLiR_TemperatureMode_Fahrenheit:
+            return "F";
+        case LeptonFLiR_TemperatureMode_Kelvin:
+            return "K";
+        default:
+            return "";
+    }
+}
+
+byte LeptonFLiR::getLastI2CError() {
+    return _lastI2CError;
+}
+
+LEP_RESULT LeptonFLiR::getLastLepResult() {
+    return (LEP_RESULT)_lastLepResult;
+}
+
+// Settable attributes kept by configuration profiles (and the shadow cache), as command ID,
+// profile word offset, word count, and mask of status words (changed by the module on its
+// own, so neither compared nor cached). Left out are the shutter position and the user LUT.
+#define LEPFLIR_PROFILE_FIELD(cmdID, field, statusMask) \
+    cmdID, (uint16_t)(offsetof(LeptonConfigProfile, field) / 2), (uint16_t)(sizeof(((LeptonConfigProfile *)0)->field) / 2), statusMask
+
+static const uint16_t configProfileFields[] PROGMEM = {
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_ENABLE_STATE, agcEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_POLICY, agcPolicy, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_SCALE_FACTOR, agcHEQScaleFactor, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_CALC_ENABLE_STATE, agcCalcEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_SYS_TELEMETRY_ENABLE_STATE, sysTelemetryEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_SYS_TELEMETRY_LOCATION, sysTelemetryLocation, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_SYS_NUM_FRAMES_TO_AVERAGE, sysFramesToAverage, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_POLARITY_SELECT, vidPolarity, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_LUT_SELECT, vidPseudoColorLUT, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_FOCUS_CALC_ENABLE, vidFocusCalcEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_FOCUS_THRESHOLD, vidFocusThreshold, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_SBNUC_ENABLE, vidSBNUCEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_GAMMA_SELECT, vidGamma, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_FREEZE_ENABLE, vidFreezeEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_RAD_ENABLE_STATE, radEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_RAD_TLINEAR_ENABLE_STATE, radTLinearEnabled, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_RAD_TLINEAR_RESOLUTION, radTLinearResolution, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_SYS_FFC_SHUTTER_MODE, sysFFCShutterMode, 0x03CC), // tempLockoutState, ffcDesired, elapsedTimeSinceLastFFC
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_ROI, agcRegion, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HISTOGRAM_CLIP_PERCENT, agcHistogramClipPercent, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HISTOGRAM_TAIL_SIZE, agcHistogramTailSize, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_LINEAR_MAX_GAIN, agcLinearMaxGain, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_LINEAR_MIDPOINT, agcLinearMidpoint, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_LINEAR_DAMPENING_FACTOR, agcLinearDampeningFactor, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_DAMPENING_FACTOR, agcHEQDampeningFactor, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_MAX_GAIN, agcHEQMaxGain, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_CLIP_LIMIT_HIGH, agcHEQClipLimitHigh, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_CLIP_LIMIT_LOW, agcHEQClipLimitLow, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_BIN_EXTENSION, agcHEQBinExtension, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_MIDPOINT, agcHEQMidpoint, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_EMPTY_COUNTS, agcHEQEmptyCounts, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_AGC_HEQ_NORMALIZATION_FACTOR, agcHEQNormalizationFactor, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_SYS_SCENE_ROI, sysSceneRegion, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_VID_FOCUS_ROI, vidFocusRegion, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_RAD_SPOTMETER_ROI, radSpotmeterRegion, 0),
+    LEPFLIR_PROFILE_FIELD(LEP_CID_RAD_FLUX_LINEAR_PARAMS, radFluxLinearParams, 0)
+};
+
+#if __cplusplus >= 201103L
+static_assert(sizeof(configProfileFields) / sizeof(configProfileFields[0]) == LEPFLIR_CONFIG_PROFILE_FIELDS * 4, "Config profile field table out of step with LEPFLIR_CONFIG_PROFILE_FIELDS");
+#endif
+
+#define LEPFLIR_PROFILE_FIELD_CMD_ID(field)         pgm_read_word(&configProfileFields[((field) * 4) + 0])
+#define LEPFLIR_PROFILE_FIELD_OFFSET(field)         pgm_read_word(&configProfileFields[((field) * 4) + 1])
+#define LEPFLIR_PROFILE_FIELD_LENGTH(field)         pgm_read_word(&configProfileFields[((field) * 4) + 2])
+#define LEPFLIR_PROFILE_FIELD_STATUS_MASK(field)    pgm_read_word(&configProfileFields[((field) * 4) + 3])
+#define LEPFLIR_PROFILE_FIELD_VALID(profile, field) ((profile)->fieldsValid[(field) / 8] & (1 << ((field) % 8)))
+#define LEPFLIR_CONFIG_PROFILE_VERSION              1
+
+void LeptonFLiR::setShadowCacheEnabled(bool enabled, uint16_t checkInterval) {
+    _shadowCacheInterval = checkInterval;
+
+    if (enabled && !_shadowCacheEnabled) {
+        if (_memoryArena && !_shadowCache && (_imageData || _imageRowData || _spiFrameData)) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+            Serial.println("  LeptonFLiR::setShadowCacheEnabled Shadow cache must first be enabled before init when using a memory arena. Ignoring.");
+#endif
+            return;
+        }
+
+        if (!_memoryArena) {
+            _shadowCache = (LeptonConfigProfile *)malloc(sizeof(LeptonConfigProfile));
+            if (!_shadowCache) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+                Serial.println("  LeptonFLiR::setShadowCacheEnabled Failure allocating shadowCache.");
+#endif
+                return;
+            }
+        }
+
+        _shadowCacheEnabled = true;
+        invalidateShadowCache();
+        validateShadowCache();
+    }
+    else if (!enabled && _shadowCacheEnabled) {
+        _shadowCacheEnabled = false;
+        if (!_memoryArena) { // arena storage is kept for when re-enabled
+            free(_shadowCache);
+            _shadowCache = NULL;
+        }
+    }
+}
+
+bool LeptonFLiR::getShadowCacheEnabled() {
+    return _shadowCacheEnabled;
+}
+
+bool LeptonFLiR::validateShadowCache() {
+    if (!_shadowCacheEnabled || !_shadowCache) return false;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::validateShadowCache");
+#endif
+
+    // Module command count includes this command itself, as does ours once issued
+    LEP_SYS_CAM_STATUS camStatus;
+    receiveCommand(cmdCode(LEP_CID_SYS_CAM_STATUS, LEP_I2C_COMMAND_TYPE_GET), (uint16_t *)&camStatus, sizeof(LEP_SYS_CAM_STATUS) / 2);
+    _shadowCacheMillis = millis();
+
+    if (_lastI2CError || _lastLepResult || !_commandCountValid || camStatus.commandCount != _commandCount) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+        if (!_lastI2CError && !_lastLepResult && _commandCountValid)
+            Serial.println("  LeptonFLiR::validateShadowCache Module command count mismatch, invalidating.");
+#endif
+        invalidateShadowCache();
+        _commandCountValid = !_lastI2CError && !_lastLepResult;
+        _commandCount = camStatus.commandCount;
+        return false;
+    }
+
+    return true;
+}
+
+void LeptonFLiR::invalidateShadowCache() {
+    if (!_shadowCache) return;
+    memset(_shadowCache->fieldsValid, 0, sizeof(_shadowCache->fieldsValid));
+}
+
+static bool configProfileFieldDiffers(int field, uint16_t *dataWords, uint16_t *otherWords) {
+    uint16_t statusMask = LEPFLIR_PROFILE_FIELD_STATUS_MASK(field);
+    int dataLength = LEPFLIR_PROFILE_FIELD_LENGTH(field);
+
+    for (int i = 0; i < dataLength; ++i) {
+        if (!(statusMask & (1 << i)) && dataWords[i] != otherWords[i])
+            return true;
+    }
+
+    return false;
+}
+
+int LeptonFLiR::captureConfigProfile(LeptonConfigProfile *profile) {
+    if (!profile) return 0;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::captureConfigProfile");
+#endif
+
+    memset(profile, 0, sizeof(LeptonConfigProfile));
+    bool moduleReady = false;
+    int fieldsCaptured = 0;
+
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (readConfigProfileField(field, (uint16_t *)profile + LEPFLIR_PROFILE_FIELD_OFFSET(field), &moduleReady)) {
+            profile->fieldsValid[field / 8] |= (1 << (field % 8));
+            ++fieldsCaptured;
+        }
+    }
+
+    return fieldsCaptured;
 }
 
-uint32_t LeptonFLiR::vid_getGamma() {
+int LeptonFLiR::diffConfigProfile(LeptonConfigProfile *profile, byte *diffFields) {
+    if (!profile) return 0;
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
-    Serial.println("LeptonFLiR::vid_getGamma");
+    Serial.println("LeptonFLiR::diffConfigProfile");
 #endif
 
-    uint32_t gamma;
-    receiveCommand(cmdCode(LEP_CID_VID_GAMMA_SELECT, LEP_I2C_COMMAND_TYPE_GET), &gamma);
-    return gamma;
+    if (diffFields) memset(diffFields, 0, (LEPFLIR_CONFIG_PROFILE_FIELDS + 7) / 8);
+    uint16_t liveWords[sizeof(LEP_SYS_FFC_SHUTTER_MODE) / 2]; // largest field
+    bool moduleReady = false;
+    int fieldsDiffering = 0;
+
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (!LEPFLIR_PROFILE_FIELD_VALID(profile, field)) continue;
+
+        if (!readConfigProfileField(field, liveWords, &moduleReady) ||
+            configProfileFieldDiffers(field, (uint16_t *)profile + LEPFLIR_PROFILE_FIELD_OFFSET(field), liveWords)) {
+            if (diffFields) diffFields[field / 8] |= (1 << (field % 8));
+            ++fieldsDiffering;
+        }
+    }
+
+    return fieldsDiffering;
 }
 
+int LeptonFLiR::applyConfigProfile(LeptonConfigProfile *profile, bool changedOnly) {
+    if (!profile) return 0;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.println("LeptonFLiR::applyConfigProfile");
 #endif
 
-static inline void byteToHexString(byte value, char *buffer) {
-    byte highNibble = value / 16;
-    byte lowNibble = value % 16;
-    if (highNibble < 10) buffer[0] = '0' + highNibble;
-    else buffer[0] = 'A' + (highNibble - 10);
-    if (lowNibble < 10) buffer[1] = '0' + lowNibble;
-    else buffer[1] = 'A' + (lowNibble - 10);
-}
+    uint16_t liveWords[sizeof(LEP_SYS_FFC_SHUTTER_MODE) / 2]; // largest field
+    bool moduleReady = false;
+    int fieldsFailed = 0;
 
-void wordsToHexString(uint16_t *dataWords, int dataLength, char *buffer, int maxLength) {
-    bool insertColons = maxLength >= (dataLength * 4) + (dataLength - 1);
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (!LEPFLIR_PROFILE_FIELD_VALID(profile, field)) continue;
+        uint16_t *dataWords = (uint16_t *)profile + LEPFLIR_PROFILE_FIELD_OFFSET(field);
 
-    while (dataLength-- > 0 && maxLength > 3) {
-        if (maxLength > 3) {
-            byteToHexString(highByte(*dataWords), buffer);
-            buffer += 2; maxLength -= 2;
-            byteToHexString(lowByte(*dataWords), buffer);
-            buffer += 2; maxLength -= 2;
-            ++dataWords;
-        }
+        if (changedOnly && readConfigProfileField(field, liveWords, &moduleReady) &&
+            !configProfileFieldDiffers(field, dataWords, liveWords))
+            continue;
 
-        if (dataLength > 0 && insertColons && maxLength-- > 0)
-            *buffer++ = ':';
+        CommandRequest request;
+        memset(&request, 0, sizeof(CommandRequest));
+        request.cmdID = LEPFLIR_PROFILE_FIELD_CMD_ID(field);
+        request.cmdType = LEP_I2C_COMMAND_TYPE_SET;
+        request.dataWords = dataWords;
+        request.dataLength = LEPFLIR_PROFILE_FIELD_LENGTH(field);
+
+        moduleReady = runBatchCommand(&request, moduleReady);
+        if (request.status == LeptonFLiR_CommandStatus_Failed) ++fieldsFailed;
     }
 
-    if (maxLength-- > 0)
-        *buffer++ = '\0';
+    return fieldsFailed;
 }
 
-float kelvin100ToCelsius(uint16_t kelvin100) {
-    float kelvin = (kelvin100 / 100) + ((kelvin100 % 100) * 0.01f);
-    return kelvin - 273.15f;
-}
+int LeptonFLiR::serializeConfigProfile(LeptonConfigProfile *profile, byte *data, int maxBytes) {
+    if (!profile || !data) return 0;
 
-float kelvin100ToFahrenheit(uint16_t kelvin100) {
-    float kelvin = (kelvin100 / 100) + ((kelvin100 % 100) * 0.01f);
-    return roundf((((kelvin * 9.0f) / 5.0f) - 459.67f) * 100.0f) / 100.0f;
-}
+    int dataBytes = 1 + sizeof(profile->fieldsValid) + 2;
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (LEPFLIR_PROFILE_FIELD_VALID(profile, field))
+            dataBytes += LEPFLIR_PROFILE_FIELD_LENGTH(field) * 2;
+    }
+    if (maxBytes < dataBytes) return 0;
 
-float kelvin100ToKelvin(uint16_t kelvin100) {
-    return (kelvin100 / 100) + ((kelvin100 % 100) * 0.01f);
-}
+    // Version, field valid bits, little endian field words, then CRC of all preceding
+    byte *writeData = data;
+    *writeData++ = LEPFLIR_CONFIG_PROFILE_VERSION;
+    memcpy(writeData, profile->fieldsValid, sizeof(profile->fieldsValid));
+    writeData += sizeof(profile->fieldsValid);
 
-uint16_t celsiusToKelvin100(float celsius) {
-    float kelvin = celsius + 273.15f;
-    return (uint16_t)roundf(kelvin * 100.0f);
-}
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (!LEPFLIR_PROFILE_FIELD_VALID(profile, field)) continue;
+        uint16_t *dataWords = (uint16_t *)profile + LEPFLIR_PROFILE_FIELD_OFFSET(field);
 
-uint16_t fahrenheitToKelvin100(float fahrenheit) {
-    float kelvin = ((fahrenheit + 459.67f) * 5.0f) / 9.0f;
-    return (uint16_t)roundf(kelvin * 100.0f);
-}
+        for (int i = LEPFLIR_PROFILE_FIELD_LENGTH(field); i > 0; --i, ++dataWords) {
+            *writeData++ = lowByte(*dataWords);
+            *writeData++ = highByte(*dataWords);
+        }
+    }
 
-uint16_t kelvinToKelvin100(float kelvin) {
-    return (uint16_t)roundf(kelvin * 100.0f);
+    uint16_t crc = LeptonFLiRTransport::calculateCRC(data, writeData - data);
+    *writeData++ = lowByte(crc);
+    *writeData++ = highByte(crc);
+
+    return dataBytes;
 }
 
-float LeptonFLiR::kelvin100ToTemperature(uint16_t kelvin100) {
-    switch (_tempMode) {
-        case LeptonFLiR_TemperatureMode_Celsius:
-            return kelvin100ToCelsius(kelvin100);
-        case LeptonFLiR_TemperatureMode_Fahrenheit:
-            return kelvin100ToFahrenheit(kelvin100);
-        case LeptonFLiR_TemperatureMode_Kelvin:
-            return kelvin100ToKelvin(kelvin100);
-        default:
-            return 0;
+bool LeptonFLiR::deserializeConfigProfile(byte *data, int dataBytes, LeptonConfigProfile *profile) {
+    if (!data || !profile || dataBytes < (int)(1 + sizeof(profile->fieldsValid) + 2) || data[0] != LEPFLIR_CONFIG_PROFILE_VERSION)
+        return false;
+
+    LeptonConfigProfile readProfile;
+    memset(&readProfile, 0, sizeof(LeptonConfigProfile));
+    memcpy(readProfile.fieldsValid, data + 1, sizeof(readProfile.fieldsValid));
+
+    // Unused valid bits past the last field would indicate a newer or corrupted blob
+    if (readProfile.fieldsValid[sizeof(readProfile.fieldsValid) - 1] & (byte)(0xFF << (LEPFLIR_CONFIG_PROFILE_FIELDS % 8 ? LEPFLIR_CONFIG_PROFILE_FIELDS % 8 : 8)))
+        return false;
+
+    int blobBytes = 1 + sizeof(readProfile.fieldsValid) + 2;
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (LEPFLIR_PROFILE_FIELD_VALID(&readProfile, field))
+            blobBytes += LEPFLIR_PROFILE_FIELD_LENGTH(field) * 2;
     }
-}
+    if (dataBytes < blobBytes || LeptonFLiRTransport::calculateCRC(data, blobBytes - 2) != (data[blobBytes - 2] | ((uint16_t)data[blobBytes - 1] << 8)))
+        return false;
 
-uint16_t LeptonFLiR::temperatureToKelvin100(float temperature) {
-    switch (_tempMode) {
-        case LeptonFLiR_TemperatureMode_Celsius:
-            return celsiusToKelvin100(temperature);
-        case LeptonFLiR_TemperatureMode_Fahrenheit:
-            return fahrenheitToKelvin100(temperature);
-        case LeptonFLiR_TemperatureMode_Kelvin:
-            return kelvinToKelvin100(temperature);
-        default:
-            return 0;
+    byte *readData = data + 1 + sizeof(readProfile.fieldsValid);
+
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (!LEPFLIR_PROFILE_FIELD_VALID(&readProfile, field)) continue;
+        uint16_t *dataWords = (uint16_t *)&readProfile + LEPFLIR_PROFILE_FIELD_OFFSET(field);
+
+        for (int i = LEPFLIR_PROFILE_FIELD_LENGTH(field); i > 0; --i, ++dataWords, readData += 2)
+            *dataWords = readData[0] | ((uint16_t)readData[1] << 8);
     }
+
+    *profile = readProfile;
+    return true;
 }
 
-const char *LeptonFLiR::getTemperatureSymbol() {
-    switch (_tempMode) {
-        case LeptonFLiR_TemperatureMode_Celsius:
-            return "C";
-        case LeptonFLiR_TemperatureMode_Fahrenheit:
-            return "F";
-        case LeptonFLiR_TemperatureMode_Kelvin:
-            return "K";
-        default:
-            return "";
-    }
+void LeptonFLiR::setCommandPollInterval(uint16_t initialMicros, uint16_t maxMicros) {
+    _cmdPollMinMicros = initialMicros;
+    _cmdPollMaxMicros = maxMicros;
 }
 
-byte LeptonFLiR::getLastI2CError() {
-    return _lastI2CError;
+void LeptonFLiR::getCommandStats(CommandStats *stats) {
+    if (!stats) return;
+    *stats = _cmdStats;
 }
 
-LEP_RESULT LeptonFLiR::getLastLepResult() {
-    return (LEP_RESULT)_lastLepResult;
+void LeptonFLiR::resetCommandStats() {
+    memset(&_cmdStats, 0, sizeof(CommandStats));
+    _cmdStats.minMicros = 0xFFFFFFFF;
 }
 
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
@@ -1651,11 +3407,237 @@ void LeptonFLiR::checkForErrors() {
 
 #endif
 
+bool LeptonFLiR::queueCommand(CommandRequest *request) {
+    if (!request || request->status == LeptonFLiR_CommandStatus_Queued || request->status == LeptonFLiR_CommandStatus_InProgress)
+        return false;
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.print("LeptonFLiR::queueCommand cmdCode: 0x");
+    Serial.println(cmdCode(request->cmdID, request->cmdType), HEX);
+#endif
+
+    request->status = LeptonFLiR_CommandStatus_Queued;
+    request->i2cError = 0;
+    request->lepResult = LEP_OK;
+    request->next = NULL;
+
+    if (_cmdQueueTail)
+        _cmdQueueTail->next = request;
+    else {
+        _cmdQueueHead = request;
+        _cmdQueueEndTime = millis() + LEPFLIR_GEN_CMD_TIMEOUT;
+    }
+    _cmdQueueTail = request;
+
+    return true;
+}
+
+bool LeptonFLiR::pollCommandQueue() {
+    CommandRequest *request = _cmdQueueHead;
+    if (!request) return false;
+
+    uint16_t status;
+    if (readRegister(LEP_I2C_STATUS_REG, &status)) {
+        completeQueuedCommand();
+        return _cmdQueueHead != NULL;
+    }
+
+    if (status & LEP_I2C_STATUS_BUSY_BIT_MASK) {
+        if (millis() >= _cmdQueueEndTime) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+            Serial.println("  LeptonFLiR::pollCommandQueue Command timed out.");
+#endif
+            _lastLepResult = LEP_TIMEOUT_ERROR;
+            completeQueuedCommand();
+        }
+
+        return _cmdQueueHead != NULL;
+    }
+
+    uint16_t code = cmdCode(request->cmdID, request->cmdType);
+    uint16_t type = code & LEP_I2C_COMMAND_TYPE_BIT_MASK;
+
+    if (request->status == LeptonFLiR_CommandStatus_Queued) {
+        _lastLepResult = 0;
+
+        if (type == LEP_I2C_COMMAND_TYPE_SET && request->dataWords && request->dataLength ?
+            writeCmdRegister(code, request->dataWords, request->dataLength) : writeRegister(LEP_I2C_COMMAND_REG, code))
+            completeQueuedCommand();
+        else {
+            request->status = LeptonFLiR_CommandStatus_InProgress;
+            _cmdQueueEndTime = millis() + LEPFLIR_GEN_CMD_TIMEOUT;
+        }
+
+        return true;
+    }
+
+    _lastLepResult = (byte)((status & LEP_I2C_STATUS_ERROR_CODE_BIT_MASK) >> LEP_I2C_STATUS_ERROR_CODE_BIT_SHIFT);
+
+    if (type == LEP_I2C_COMMAND_TYPE_GET && !_lastLepResult)
+        readDataRegister(request->dataWords, request->dataLength);
+
+    updateCommandState(request);
+    completeQueuedCommand();
+    return _cmdQueueHead != NULL;
+}
+
+int LeptonFLiR::runCommandBatch(CommandRequest *requests, int count) {
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    Serial.print("LeptonFLiR::runCommandBatch count: ");
+    Serial.println(count);
+#endif
+
+    int failures = 0;
+    bool moduleReady = false;
+
+    for (int i = 0; i < count; ++i) {
+        moduleReady = runBatchCommand(&requests[i], moduleReady);
+        if (requests[i].status == LeptonFLiR_CommandStatus_Failed) ++failures;
+    }
+
+    return failures;
+}
+
+void LeptonFLiR::waitCommandPoll(uint16_t *pollMicros) {
+    ++_cmdStats.statusReads;
+
+    if (*pollMicros < _cmdPollMaxMicros) {
+        delayMicroseconds(*pollMicros);
+        *pollMicros = (*pollMicros ? min((uint32_t)*pollMicros << 1, (uint32_t)0xFFFF) : 1);
+    }
+    else {
+#ifdef LEPFLIR_USE_SCHEDULER
+        Scheduler.yield();
+#else
+        delay(1);
+#endif
+    }
+}
+
+void LeptonFLiR::recordCommandStats(bool timedOut) {
+    uint32_t latency = micros() - _cmdBeginMicros;
+
+    ++_cmdStats.commandCount;
+    _cmdStats.totalMicros += latency;
+    _cmdStats.lastMicros = latency;
+    if (latency < _cmdStats.minMicros) _cmdStats.minMicros = latency;
+    if (latency > _cmdStats.maxMicros) _cmdStats.maxMicros = latency;
+    if (timedOut) ++_cmdStats.timeouts;
+}
+
+// Runs a single request of a batch, returning if the module is known to be ready after it
+bool LeptonFLiR::runBatchCommand(CommandRequest *request, bool moduleReady) {
+    uint16_t code = cmdCode(request->cmdID, request->cmdType);
+    uint16_t type = code & LEP_I2C_COMMAND_TYPE_BIT_MASK;
+
+    request->status = LeptonFLiR_CommandStatus_InProgress;
+    request->next = NULL;
+
+    if (type == LEP_I2C_COMMAND_TYPE_GET && readShadowCache(code, request->dataWords, request->dataLength)) {
+        completeCommandRequest(request);
+        return moduleReady;
+    }
+
+    // Module is known not to be busy after a successful finish, so the begin wait is skipped
+    if (moduleReady) {
+        _cmdBeginMicros = micros();
+        _lastLepResult = 0;
+    }
+
+    if (moduleReady || waitCommandBegin(LEPFLIR_GEN_CMD_TIMEOUT)) {
+        if ((type == LEP_I2C_COMMAND_TYPE_SET && request->dataWords && request->dataLength ?
+             writeCmdRegister(code, request->dataWords, request->dataLength, true) : writeRegister(LEP_I2C_COMMAND_REG, code)) == 0) {
+
+            if (waitCommandFinish(LEPFLIR_GEN_CMD_TIMEOUT) && type == LEP_I2C_COMMAND_TYPE_GET && !_lastLepResult)
+                readDataRegister(request->dataWords, request->dataLength);
+        }
+    }
+
+    // Failed module results still leave the module ready, other failures do not
+    moduleReady = !_lastI2CError && _lastLepResult != (byte)LEP_TIMEOUT_ERROR;
+
+    updateCommandState(request);
+    completeCommandRequest(request);
+    return moduleReady;
+}
+
+bool LeptonFLiR::readConfigProfileField(int field, uint16_t *dataWords, bool *moduleReady) {
+    CommandRequest request;
+    memset(&request, 0, sizeof(CommandRequest));
+    request.cmdID = LEPFLIR_PROFILE_FIELD_CMD_ID(field);
+    request.cmdType = LEP_I2C_COMMAND_TYPE_GET;
+    request.dataWords = dataWords;
+    request.dataLength = LEPFLIR_PROFILE_FIELD_LENGTH(field);
+
+    *moduleReady = runBatchCommand(&request, *moduleReady);
+    return request.status == LeptonFLiR_CommandStatus_Complete;
+}
+
+void LeptonFLiR::finishQueuedCommand() {
+    // Front request's result would otherwise be lost to the next command written
+    while (_cmdQueueHead && _cmdQueueHead->status == LeptonFLiR_CommandStatus_InProgress) {
+        pollCommandQueue();
+
+        if (_cmdQueueHead && _cmdQueueHead->status == LeptonFLiR_CommandStatus_InProgress) {
+#ifdef LEPFLIR_USE_SCHEDULER
+            Scheduler.yield();
+#else
+            delay(1);
+#endif
+        }
+    }
+}
+
+void LeptonFLiR::completeQueuedCommand() {
+    CommandRequest *request = _cmdQueueHead;
+
+    if (!(_cmdQueueHead = request->next))
+        _cmdQueueTail = NULL;
+    else
+        _cmdQueueEndTime = millis() + LEPFLIR_GEN_CMD_TIMEOUT;
+    request->next = NULL;
+
+    completeCommandRequest(request);
+}
+
+void LeptonFLiR::completeCommandRequest(CommandRequest *request) {
+    request->i2cError = _lastI2CError;
+    request->lepResult = (LEP_RESULT)(int8_t)_lastLepResult;
+    request->status = (_lastI2CError || _lastLepResult ? LeptonFLiR_CommandStatus_Failed : LeptonFLiR_CommandStatus_Complete);
+
+#ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
+    checkForErrors();
+#endif
+
+    if (request->completeFunc)
+        request->completeFunc(request);
+}
+
+void LeptonFLiR::updateCommandState(CommandRequest *request) {
+    uint16_t code = cmdCode(request->cmdID, request->cmdType);
+    uint16_t type = code & LEP_I2C_COMMAND_TYPE_BIT_MASK;
+    if (type == LEP_I2C_COMMAND_TYPE_RUN) return;
+
+    writeShadowCache(code, request->dataWords, request->dataLength);
+
+    // Cached capture state is refreshed if changed from underneath it
+    uint16_t cmdID = code & ~LEP_I2C_COMMAND_TYPE_BIT_MASK;
+    if (type == LEP_I2C_COMMAND_TYPE_SET && (cmdID == LEP_CID_AGC_ENABLE_STATE || cmdID == LEP_CID_AGC_HEQ_SCALE_FACTOR ||
+        cmdID == LEP_CID_SYS_TELEMETRY_ENABLE_STATE || cmdID == LEP_CID_SYS_TELEMETRY_LOCATION))
+        _captureStateValid = false;
+    else if (cmdID == LEP_CID_RAD_TLINEAR_RESOLUTION && !_lastI2CError && !_lastLepResult && request->dataLength)
+        _tlinearResolution = (LEP_RAD_TLINEAR_RESOLUTION)request->dataWords[0];
+}
+
 bool LeptonFLiR::waitCommandBegin(int timeout) {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     Serial.println("    LeptonFLiR::waitCommandBegin");
 #endif
 
+    if (_cmdQueueHead)
+        finishQueuedCommand();
+
+    _cmdBeginMicros = micros();
     _lastLepResult = 0;
 
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
@@ -1669,13 +3651,10 @@ bool LeptonFLiR::waitCommandBegin(int timeout) {
         return true;
 
     unsigned long endTime = millis() + (unsigned long)timeout;
+    uint16_t pollMicros = _cmdPollMinMicros;
 
     while ((status & LEP_I2C_STATUS_BUSY_BIT_MASK) && (timeout <= 0 || millis() < endTime)) {
-#ifdef LEPFLIR_USE_SCHEDULER
-        Scheduler.yield();
-#else
-        delay(1);
-#endif
+        waitCommandPoll(&pollMicros);
 
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
         Serial.print("  ");
@@ -1689,6 +3668,7 @@ bool LeptonFLiR::waitCommandBegin(int timeout) {
         return true;
     else {
         _lastLepResult = LEP_TIMEOUT_ERROR;
+        recordCommandStats(true);
         return false;
     }
 }
@@ -1707,17 +3687,15 @@ bool LeptonFLiR::waitCommandFinish(int timeout) {
 
     if (!(status & LEP_I2C_STATUS_BUSY_BIT_MASK)) {
         _lastLepResult = (byte)((status & LEP_I2C_STATUS_ERROR_CODE_BIT_MASK) >> LEP_I2C_STATUS_ERROR_CODE_BIT_SHIFT);
+        recordCommandStats(false);
         return true;
     }
 
     unsigned long endTime = millis() + (unsigned long)timeout;
+    uint16_t pollMicros = _cmdPollMinMicros;
 
     while ((status & LEP_I2C_STATUS_BUSY_BIT_MASK) && (timeout <= 0 || millis() < endTime)) {
-#ifdef LEPFLIR_USE_SCHEDULER
-        Scheduler.yield();
-#else
-        delay(1);
-#endif
+        waitCommandPoll(&pollMicros);
 
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
         Serial.print("  ");
@@ -1729,16 +3707,59 @@ bool LeptonFLiR::waitCommandFinish(int timeout) {
 
     if (!(status & LEP_I2C_STATUS_BUSY_BIT_MASK)) {
         _lastLepResult = (byte)((status & LEP_I2C_STATUS_ERROR_CODE_BIT_MASK) >> LEP_I2C_STATUS_ERROR_CODE_BIT_SHIFT);
+        recordCommandStats(false);
         return true;
     }
     else {
         _lastLepResult = LEP_TIMEOUT_ERROR;
+        recordCommandStats(true);
         return false;
     }
 }
 
 uint16_t LeptonFLiR::cmdCode(uint16_t cmdID, uint16_t cmdType) {
-    return (cmdID & LEP_I2C_COMMAND_MODULE_ID_BIT_MASK) | (cmdID & LEP_I2C_COMMAND_ID_BIT_MASK) | (cmdType & LEP_I2C_COMMAND_TYPE_BIT_MASK);
+    return (cmdID & LEP_I2C_COMMAND_PROT_BIT_MASK) | (cmdID & LEP_I2C_COMMAND_MODULE_ID_BIT_MASK) | (cmdID & LEP_I2C_COMMAND_ID_BIT_MASK) | (cmdType & LEP_I2C_COMMAND_TYPE_BIT_MASK);
+}
+
+// Finds the configuration profile field of a command, or -1 if not kept
+int LeptonFLiR::findConfigProfileField(uint16_t cmdCode) {
+    uint16_t cmdID = cmdCode & ~LEP_I2C_COMMAND_TYPE_BIT_MASK;
+
+    for (int field = 0; field < LEPFLIR_CONFIG_PROFILE_FIELDS; ++field) {
+        if (LEPFLIR_PROFILE_FIELD_CMD_ID(field) == cmdID)
+            return field;
+    }
+
+    return -1;
+}
+
+bool LeptonFLiR::readShadowCache(uint16_t cmdCode, uint16_t *readWords, int maxLength) {
+    if (!_shadowCacheEnabled || !_shadowCache || (cmdCode & LEP_I2C_COMMAND_TYPE_BIT_MASK) != LEP_I2C_COMMAND_TYPE_GET) return false;
+
+    int field = findConfigProfileField(cmdCode);
+    if (field < 0 || LEPFLIR_PROFILE_FIELD_STATUS_MASK(field) || LEPFLIR_PROFILE_FIELD_LENGTH(field) != maxLength || !LEPFLIR_PROFILE_FIELD_VALID(_shadowCache, field)) return false;
+
+    if ((!_commandCountValid || millis() - _shadowCacheMillis >= _shadowCacheInterval) && !validateShadowCache())
+        return false;
+
+    memcpy(readWords, (uint16_t *)_shadowCache + LEPFLIR_PROFILE_FIELD_OFFSET(field), maxLength * 2);
+    _lastI2CError = _lastLepResult = 0;
+    return true;
+}
+
+void LeptonFLiR::writeShadowCache(uint16_t cmdCode, uint16_t *dataWords, int dataLength) {
+    if (!_shadowCacheEnabled || !_shadowCache) return;
+
+    // Fields with status words are not cached, as the module changes those on its own
+    int field = findConfigProfileField(cmdCode);
+    if (field < 0 || LEPFLIR_PROFILE_FIELD_STATUS_MASK(field)) return;
+
+    if (!_lastI2CError && !_lastLepResult && dataLength == LEPFLIR_PROFILE_FIELD_LENGTH(field)) {
+        memcpy((uint16_t *)_shadowCache + LEPFLIR_PROFILE_FIELD_OFFSET(field), dataWords, dataLength * 2);
+        _shadowCache->fieldsValid[field / 8] |= (1 << (field % 8));
+    }
+    else
+        _shadowCache->fieldsValid[field / 8] &= ~(1 << (field % 8));
 }
 
 void LeptonFLiR::sendCommand(uint16_t cmdCode) {
@@ -1774,6 +3795,8 @@ void LeptonFLiR::sendCommand(uint16_t cmdCode, uint16_t value) {
         }
     }
 
+    writeShadowCache(cmdCode, &value, 1);
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     checkForErrors();
 #endif
@@ -1793,6 +3816,8 @@ void LeptonFLiR::sendCommand(uint16_t cmdCode, uint32_t value) {
         }
     }
 
+    writeShadowCache(cmdCode, (uint16_t *)&value, 2);
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     checkForErrors();
 #endif
@@ -1812,6 +3837,8 @@ void LeptonFLiR::sendCommand(uint16_t cmdCode, uint16_t *dataWords, int dataLeng
         }
     }
 
+    writeShadowCache(cmdCode, dataWords, dataLength);
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     checkForErrors();
 #endif
@@ -1823,6 +3850,8 @@ void LeptonFLiR::receiveCommand(uint16_t cmdCode, uint16_t *value) {
     Serial.println(cmdCode, HEX);
 #endif
 
+    if (readShadowCache(cmdCode, value, 1)) return;
+
     if (waitCommandBegin(LEPFLIR_GEN_CMD_TIMEOUT)) {
 
         if (writeRegister(LEP_I2C_COMMAND_REG, cmdCode) == 0) {
@@ -1834,6 +3863,8 @@ void LeptonFLiR::receiveCommand(uint16_t cmdCode, uint16_t *value) {
         }
     }
 
+    writeShadowCache(cmdCode, value, 1);
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     checkForErrors();
 #endif
@@ -1845,6 +3876,8 @@ void LeptonFLiR::receiveCommand(uint16_t cmdCode, uint32_t *value) {
     Serial.println(cmdCode, HEX);
 #endif
 
+    if (readShadowCache(cmdCode, (uint16_t *)value, 2)) return;
+
     if (waitCommandBegin(LEPFLIR_GEN_CMD_TIMEOUT)) {
 
         if (writeRegister(LEP_I2C_COMMAND_REG, cmdCode) == 0) {
@@ -1856,6 +3889,8 @@ void LeptonFLiR::receiveCommand(uint16_t cmdCode, uint32_t *value) {
         }
     }
 
+    writeShadowCache(cmdCode, (uint16_t *)value, 2);
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     checkForErrors();
 #endif
@@ -1867,6 +3902,8 @@ void LeptonFLiR::receiveCommand(uint16_t cmdCode, uint16_t *readWords, int maxLe
     Serial.println(cmdCode, HEX);
 #endif
 
+    if (readShadowCache(cmdCode, readWords, maxLength)) return;
+
     if (waitCommandBegin(LEPFLIR_GEN_CMD_TIMEOUT)) {
 
         if (writeRegister(LEP_I2C_COMMAND_REG, cmdCode) == 0) {
@@ -1878,12 +3915,14 @@ void LeptonFLiR::receiveCommand(uint16_t cmdCode, uint16_t *readWords, int maxLe
         }
     }
 
+    writeShadowCache(cmdCode, readWords, maxLength);
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     checkForErrors();
 #endif
 }
 
-int LeptonFLiR::writeCmdRegister(uint16_t cmdCode, uint16_t *dataWords, int dataLength) {
+int LeptonFLiR::writeCmdRegister(uint16_t cmdCode, uint16_t *dataWords, int dataLength, bool packLength) {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     Serial.print("    LeptonFLiR::writeCmdRegister cmdCode: 0x");
     Serial.print(cmdCode, HEX);
@@ -1901,7 +3940,17 @@ int LeptonFLiR::writeCmdRegister(uint16_t cmdCode, uint16_t *dataWords, int data
     // how many words can be written at once. Therefore, we loop around until all words
     // have been written out into their registers.
 
-    if (dataWords && dataLength) {
+    // Data length register directly precedes data 0 register, so both may be written at once
+    if (packLength && dataWords && dataLength && (dataLength + 2) * 2 <= BUFFER_LENGTH) {
+        i2cWire_beginTransmission(LEP_I2C_DEVICE_ADDRESS);
+        i2cWire_write16(LEP_I2C_DATA_LENGTH_REG);
+        i2cWire_write16(dataLength);
+        while (dataLength-- > 0)
+            i2cWire_write16(*dataWords++);
+        if (i2cWire_endTransmission())
+            return _lastI2CError;
+    }
+    else if (dataWords && dataLength) {
         i2cWire_beginTransmission(LEP_I2C_DEVICE_ADDRESS);
         i2cWire_write16(LEP_I2C_DATA_LENGTH_REG);
         i2cWire_write16(dataLength);
@@ -1931,7 +3980,7 @@ int LeptonFLiR::writeCmdRegister(uint16_t cmdCode, uint16_t *dataWords, int data
     i2cWire_beginTransmission(LEP_I2C_DEVICE_ADDRESS);
     i2cWire_write16(LEP_I2C_COMMAND_REG);
     i2cWire_write16(cmdCode);
-    return i2cWire_endTransmission();
+    return countCommand(i2cWire_endTransmission());
 }
 
 int LeptonFLiR::readDataRegister(uint16_t *readWords, int maxLength) {
@@ -2022,9 +4071,18 @@ int LeptonFLiR::writeRegister(uint16_t regAddress, uint16_t value) {
     i2cWire_beginTransmission(LEP_I2C_DEVICE_ADDRESS);
     i2cWire_write16(regAddress);
     i2cWire_write16(value);
+    if (regAddress == LEP_I2C_COMMAND_REG)
+        return countCommand(i2cWire_endTransmission());
     return i2cWire_endTransmission();
 }
 
+int LeptonFLiR::countCommand(int i2cError) {
+    // Module command count can't be relied upon to stay in step after a failed write
+    if (i2cError) _commandCountValid = false;
+    else ++_commandCount;
+    return i2cError;
+}
+
 int LeptonFLiR::readRegister(uint16_t regAddress, uint16_t *value) {
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     Serial.print("    LeptonFLiR::readRegister regAddress: 0x");
@@ -2202,13 +4260,13 @@ void LeptonFLiR::printModuleInfo() {
     mallocOffset = 15;
 #endif
     Serial.print("Image Data: ");
-    Serial.print(_imageData ? getImageTotalBytes() + mallocOffset : 0);
+    Serial.print(_imageData || _imageRowData ? getImageBuffersTotalBytes() + mallocOffset : 0);
     Serial.print("B, SPI Frame Data: ");
     Serial.print(_spiFrameData ? getSPIFrameTotalBytes() + mallocOffset : 0);
     Serial.print("B, Telemetry Data: ");
-    Serial.print(_telemetryData ? LEPFLIR_SPI_FRAME_PACKET_SIZE : 0);
+    Serial.print(_telemetryData ? _frameBufferCount * LEPFLIR_SPI_FRAME_PACKET_SIZE : 0);
     Serial.print("B, Total: ");
-    Serial.print((_imageData ? getImageTotalBytes() + mallocOffset : 0) + (_spiFrameData ? getSPIFrameTotalBytes() + mallocOffset : 0) + (_telemetryData ? LEPFLIR_SPI_FRAME_PACKET_SIZE : 0));
+    Serial.print((_imageData || _imageRowData ? getImageBuffersTotalBytes() + mallocOffset : 0) + (_spiFrameData ? getSPIFrameTotalBytes() + mallocOffset : 0) + (_telemetryData ? _frameBufferCount * LEPFLIR_SPI_FRAME_PACKET_SIZE : 0));
     Serial.println("B");
 
     Serial.println(""); Serial.println("Power Register:");
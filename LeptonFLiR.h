@@ -39,6 +39,9 @@
 // Uncomment this define to disable 16 byte aligned memory allocations (may hinder performance).
 //#define LEPFLIR_DISABLE_ALIGNED_MALLOC  1
 
+// Uncomment this define to disable block SPI packet transfers, reverting to per-word transfers.
+//#define LEPFLIR_DISABLE_SPI_BLOCK_TRANSFER 1
+
 // Uncomment this define if wanting to exclude extended i2c functions from compilation.
 //#define LEPFLIR_EXCLUDE_EXT_I2C_FUNCS   1
 
@@ -71,6 +74,7 @@
 #endif
 #include <SPI.h>
 #include "LeptonFLiRDefs.h"
+#include "LeptonFLiRTransport.h"
 
 #ifndef ENABLED
 #define ENABLED  0x1
@@ -79,6 +83,12 @@
 #define DISABLED 0x0
 #endif
 
+#if __cplusplus >= 201103L
+#define LEPFLIR_CONSTEXPR constexpr
+#else
+#define LEPFLIR_CONSTEXPR inline
+#endif
+
 typedef enum {
     TelemetryData_FFCState_NeverCommanded,
     TelemetryData_FFCState_InProgress,
@@ -108,29 +118,73 @@ typedef struct {
     uint16_t log2FFCFrames;
 } TelemetryData;
 
+typedef struct {
+    uint16_t minValue;              // Minimum pixel value (in image data units)
+    uint16_t maxValue;              // Maximum pixel value (in image data units)
+    byte minRow, minCol;            // Location of first minimum pixel value
+    byte maxRow, maxCol;            // Location of first maximum pixel value (aka hotspot)
+    uint32_t sum;                   // Sum of all pixel values
+    uint16_t mean;                  // Mean pixel value (rounded down)
+    uint16_t threshold;             // Threshold pixel value (see setFrameStatsEnabled)
+    uint16_t thresholdCount;        // Pixels with value at or above threshold
+} FrameStats;
+
 // Memory Footprint Note
 // Image storage mode affects the total memory footprint. Memory constrained boards
 // should take notice to the storage requirements. Note that the Lepton FLiR delivers
 // 14bpp thermal image data with AGC mode disabled and 8bpp thermal image data with AGC
 // mode enabled, therefore if using AGC mode always enabled it is more memory efficient
 // to use an 8bpp mode to begin with. Note that with telemetry enabled, memory cost
-// incurs an additional 164 bytes for telemetry data storage.
+// incurs an additional 164 bytes for telemetry data storage. Note that when using an
+// asynchronous transport (see setTransport), memory cost incurs an additional 164 bytes
+// for read frame double buffering. Note that with multiple frame buffers (see
+// setFrameBufferCount), image data and telemetry data storage costs are multiplied by
+// the frame buffer count. Note that with an image row callback (see setImageRowCallback),
+// image data storage is replaced by a single image row (i.e. image pitch bytes). Note
+// that with a memory arena (see setMemoryArena), storage is carved out of the arena in
+// place of the heap, with telemetry data storage always reserved. Note that with
+// software AGC (see setSoftAGCEnabled), memory cost incurs an additional 768 bytes for
+// histogram and LUT storage. Note that with the shadow cache (see setShadowCacheEnabled),
+// memory cost incurs an additional sizeof(LeptonConfigProfile) bytes for cached camera
+// settings (a configuration profile), carved out of the memory arena when one is set.
+// Read frame buffering is kept to a single packet, with downscaled modes summing each
+// packet into per column sums of the image row being assembled as it arrives.
+// Lepton 3.x (160x120) modes are only for use with Lepton 3.x modules, and are read in
+// four segments. Downscaled Lepton 3.x modes also keep a copy of the column sums of any
+// partial row carried over from the previous segment, in case the next segment gets
+// discarded (e.g. an invalid segment). With an image row callback, that copy also
+// includes the image row (i.e. an additional image pitch bytes).
 typedef enum {
     // Full 16bpp image mode, 9600 bytes for image data, 164 bytes for read frame (9604 bytes total, 9806 bytes if aligned)
     LeptonFLiR_ImageStorageMode_80x60_16bpp,
     // Full 8bpp image mode, 4800 bytes for image data, 164 bytes for read frame (4964 bytes total, 5006 bytes if aligned)
     LeptonFLiR_ImageStorageMode_80x60_8bpp,
 
-    // Halved 16bpp image mode, 2400 bytes for image data, 328 bytes for read frame (2728 bytes total, 2782 bytes if aligned)
+    // Halved 16bpp image mode, 2400 bytes for image data, 324 bytes for read frame (2724 bytes total, 2766 bytes if aligned)
     LeptonFLiR_ImageStorageMode_40x30_16bpp,
-    // Halved 8bpp image mode, 1200 bytes for image data, 328 bytes for read frame (1528 bytes total, 1814 bytes if aligned)
+    // Halved 8bpp image mode, 1200 bytes for image data, 324 bytes for read frame (1524 bytes total, 1798 bytes if aligned)
     LeptonFLiR_ImageStorageMode_40x30_8bpp,
 
-    // Quartered 16bpp image mode, 600 bytes for image data, 656 bytes for read frame (1256 bytes total, 1446 bytes if aligned)
+    // Quartered 16bpp image mode, 600 bytes for image data, 244 bytes for read frame (844 bytes total, 998 bytes if aligned)
     LeptonFLiR_ImageStorageMode_20x15_16bpp,
-    // Quartered 8bpp image mode, 300 bytes for image data, 656 bytes for read frame (956 bytes total, 1202 bytes if aligned)
+    // Quartered 8bpp image mode, 300 bytes for image data, 244 bytes for read frame (544 bytes total, 754 bytes if aligned)
     LeptonFLiR_ImageStorageMode_20x15_8bpp,
 
+    // Lepton 3.x full 16bpp image mode, 38400 bytes for image data, 164 bytes for read frame (38564 bytes total, 38606 bytes if aligned)
+    LeptonFLiR_ImageStorageMode_L3_160x120_16bpp,
+    // Lepton 3.x full 8bpp image mode, 19200 bytes for image data, 164 bytes for read frame (19364 bytes total, 19406 bytes if aligned)
+    LeptonFLiR_ImageStorageMode_L3_160x120_8bpp,
+
+    // Lepton 3.x halved 16bpp image mode, 9600 bytes for image data, 804 bytes for read frame (10404 bytes total, 10446 bytes if aligned)
+    LeptonFLiR_ImageStorageMode_L3_80x60_16bpp,
+    // Lepton 3.x halved 8bpp image mode, 4800 bytes for image data, 804 bytes for read frame (5604 bytes total, 5646 bytes if aligned)
+    LeptonFLiR_ImageStorageMode_L3_80x60_8bpp,
+
+    // Lepton 3.x quartered 16bpp image mode, 2400 bytes for image data, 484 bytes for read frame (2884 bytes total, 2926 bytes if aligned)
+    LeptonFLiR_ImageStorageMode_L3_40x30_16bpp,
+    // Lepton 3.x quartered 8bpp image mode, 1200 bytes for image data, 484 bytes for read frame (1684 bytes total, 1958 bytes if aligned)
+    LeptonFLiR_ImageStorageMode_L3_40x30_8bpp,
+
     LeptonFLiR_ImageStorageMode_Count
 } LeptonFLiR_ImageStorageMode;
 
@@ -142,6 +196,104 @@ typedef enum {
     LeptonFLiR_TemperatureMode_Count
 } LeptonFLiR_TemperatureMode;
 
+typedef enum {
+    LeptonFLiR_FrameStatus_InProgress,
+    LeptonFLiR_FrameStatus_FrameReady,
+    LeptonFLiR_FrameStatus_Failed
+} LeptonFLiR_FrameStatus;
+
+typedef enum {
+    LeptonFLiR_CommandStatus_Idle,              // Not queued
+    LeptonFLiR_CommandStatus_Queued,            // Queued, waiting for module to be ready
+    LeptonFLiR_CommandStatus_InProgress,        // Written to module, waiting for it to finish
+    LeptonFLiR_CommandStatus_Complete,
+    LeptonFLiR_CommandStatus_Failed             // See i2cError and lepResult
+} LeptonFLiR_CommandStatus;
+
+typedef enum {
+    LeptonFLiR_ColorFormat_RGB565,              // 16bpp, native byte order
+    LeptonFLiR_ColorFormat_RGB565_BigEndian,    // 16bpp, high byte first (e.g. for SPI TFT displays)
+    LeptonFLiR_ColorFormat_RGB888,              // 24bpp, red byte first
+    LeptonFLiR_ColorFormat_BGR888,              // 24bpp, blue byte first (e.g. for BMP files)
+
+    LeptonFLiR_ColorFormat_Count
+} LeptonFLiR_ColorFormat;
+
+typedef enum {
+    LeptonFLiR_ScaleFilter_Nearest,             // Nearest neighbour, blocky but fastest
+    LeptonFLiR_ScaleFilter_Bilinear,            // Bilinear, smooth when upscaling
+
+    LeptonFLiR_ScaleFilter_Count
+} LeptonFLiR_ScaleFilter;
+
+typedef struct CommandRequest {
+    uint16_t cmdID;                 // Command ID (e.g. LEP_CID_SYS_RUN_FFC)
+    uint16_t cmdType;               // LEP_I2C_COMMAND_TYPE_GET, LEP_I2C_COMMAND_TYPE_SET, or LEP_I2C_COMMAND_TYPE_RUN
+    uint16_t *dataWords;            // Data to send (set) or buffer to receive into (get), left in place until done
+    int dataLength;                 // Data length (words)
+    void (*completeFunc)(struct CommandRequest *); // Called once complete or failed, may be NULL
+    void *userData;                 // Passed along untouched, for use by completeFunc
+    LeptonFLiR_CommandStatus status; // Zero initialize (idle) before first queued
+    byte i2cError;                  // I2C error of command (see getLastI2CError)
+    LEP_RESULT lepResult;           // Module result of command (see getLastLepResult)
+    struct CommandRequest *next;    // Queue link (internal)
+} CommandRequest;
+
+typedef struct {
+    uint32_t commandCount;          // Blocking commands finished (or timed out)
+    uint32_t totalMicros;           // Sum of command latencies (microseconds)
+    uint32_t minMicros;             // Fastest command latency (microseconds)
+    uint32_t maxMicros;             // Slowest command latency (microseconds)
+    uint32_t lastMicros;            // Last command latency (microseconds)
+    uint32_t statusReads;           // Status register reads spent waiting on busy module
+    uint16_t timeouts;              // Commands that timed out
+} CommandStats;
+
+#define LEPFLIR_CONFIG_PROFILE_FIELDS       36  // Settable attributes kept by a configuration profile
+#define LEPFLIR_CONFIG_PROFILE_MAX_BYTES    182 // Serialized profile size with all fields valid
+
+// Settable camera attributes, as sent over i2c. Two word values are kept as uint32_t (and
+// listed first), so that the layout is the same on 8-bit and 32-bit architectures.
+typedef struct {
+    uint32_t agcEnabled;                        // bool def:disabled
+    uint32_t agcPolicy;                         // LEP_AGC_POLICY def:LEP_AGC_HEQ
+    uint32_t agcHEQScaleFactor;                 // LEP_AGC_HEQ_SCALE_FACTOR def:LEP_AGC_SCALE_TO_8_BITS
+    uint32_t agcCalcEnabled;                    // bool def:disabled
+    uint32_t sysTelemetryEnabled;               // bool def:enabled
+    uint32_t sysTelemetryLocation;              // LEP_SYS_TELEMETRY_LOCATION def:LEP_TELEMETRY_LOCATION_FOOTER
+    uint32_t sysFramesToAverage;                // LEP_SYS_FRAME_AVERAGE def:LEP_SYS_FA_DIV_8
+    uint32_t vidPolarity;                       // LEP_VID_POLARITY def:LEP_VID_WHITE_HOT
+    uint32_t vidPseudoColorLUT;                 // LEP_VID_PCOLOR_LUT def:LEP_VID_FUSION_LUT
+    uint32_t vidFocusCalcEnabled;               // bool def:disabled
+    uint32_t vidFocusThreshold;                 // def:30
+    uint32_t vidSBNUCEnabled;                   // bool def:enabled
+    uint32_t vidGamma;                          // def:58
+    uint32_t vidFreezeEnabled;                  // bool def:disabled
+    uint32_t radEnabled;                        // bool def:enabled
+    uint32_t radTLinearEnabled;                 // bool def:enabled
+    uint32_t radTLinearResolution;              // LEP_RAD_TLINEAR_RESOLUTION def:LEP_RAD_RESOLUTION_0_01
+    LEP_SYS_FFC_SHUTTER_MODE sysFFCShutterMode; // Status fields (temp lockout state, FFC desired, elapsed time) not compared
+    LEP_AGC_HISTOGRAM_ROI agcRegion;
+    uint16_t agcHistogramClipPercent;
+    uint16_t agcHistogramTailSize;
+    uint16_t agcLinearMaxGain;
+    uint16_t agcLinearMidpoint;
+    uint16_t agcLinearDampeningFactor;
+    uint16_t agcHEQDampeningFactor;
+    uint16_t agcHEQMaxGain;
+    uint16_t agcHEQClipLimitHigh;
+    uint16_t agcHEQClipLimitLow;
+    uint16_t agcHEQBinExtension;
+    uint16_t agcHEQMidpoint;
+    uint16_t agcHEQEmptyCounts;
+    uint16_t agcHEQNormalizationFactor;
+    LEP_SYS_SCENE_ROI sysSceneRegion;
+    LEP_VID_FOCUS_ROI vidFocusRegion;
+    LEP_RAD_ROI radSpotmeterRegion;
+    LEP_RAD_FLUX_LINEAR_PARAMS radFluxLinearParams;
+    byte fieldsValid[(LEPFLIR_CONFIG_PROFILE_FIELDS + 7) / 8]; // Bit per field above, in order, set if field is in use
+} LeptonConfigProfile;
+
 class LeptonFLiR {
 public:
 #ifndef LEPFLIR_USE_SOFTWARE_I2C
@@ -173,12 +325,25 @@ public:
     int getImagePitch(); // Bytes per row (may be different than Bpp * Width, in memory aligned mode)
     int getImageTotalBytes();
 
-    // Image data access (disabled during frame read)
+    // Image data access (disabled during frame read, unless multiple frame buffers are used)
     byte *getImageData();
+    byte *getImageData(uint32_t *frameNumber); // Also returns frame number of image data
     byte *getImageDataRow(int row);
     uint16_t getImageDataRowCol(int row, int col);
 
-    // Telemetry data access (disabled during frame read)
+    // Multiple frame buffers allow image and telemetry data access during frame read, and
+    // must be set before init(). Frames are read into a back buffer that is only swapped
+    // in once the frame has been successfully read, so that accessors always return the
+    // latest complete frame (a failed frame read leaves it in place). With two buffers,
+    // image data returned may be overwritten by the frame read after the next, with three
+    // buffers by the frame read after that. When accessing data during frame read, use a
+    // single getImageData() call (with pitch for rows), as separate calls may straddle
+    // a buffer swap. Frame numbers count successfully read frames (0 meaning none yet).
+    void setFrameBufferCount(byte count); // def:1, max:3
+    byte getFrameBufferCount();
+    uint32_t getFrameNumber(); // Frame number of latest complete frame
+
+    // Telemetry data access (disabled during frame read, unless multiple frame buffers are used)
     byte *getTelemetryData(); // raw
     void getTelemetryData(TelemetryData *telemetry);
 
@@ -193,10 +358,175 @@ public:
     typedef void(*digitalWriteFunc)(byte); // Passes pin number in
     void setFastCSFuncs(digitalWriteFunc csEnableFunc, digitalWriteFunc csDisableFunc);
 
+    // Sets a method to call with each image row as it is read, already downscaled and
+    // converted per image storage mode, and must be called before init(). No image data is
+    // allocated (image data accessors return NULL), only a single image row buffer that is
+    // reused between rows. Rows may be passed in again if the frame read has to restart
+    // (e.g. after a resync, or a discarded Lepton 3.x segment), in which case they replace
+    // those passed in before. Rows make up a complete frame only once the frame read
+    // succeeds. Methods are called mid frame read, so should return quickly (see pollFrame
+    // for frame timing).
+    typedef void(*imageRowFunc)(int, byte *); // Passes image row number and row data in
+    void setImageRowCallback(imageRowFunc rowFunc);
+
+    // Sets a method to call with each raw telemetry packet (164 bytes, in host order) as it
+    // is read, with the same caveats as above. May be called at any time.
+    typedef void(*telemetryPacketFunc)(int, byte *); // Passes telemetry row (0-3) and packet data in
+    void setTelemetryPacketCallback(telemetryPacketFunc packetFunc);
+
+    // Streaming mode keeps VoSPI sync across frame reads. Normally each frame read begins
+    // with a 185ms chip select deassert to force a resync, limiting reads to ~5 fps. With
+    // streaming enabled this is only done on the first read and after sync has been lost
+    // (i.e. a discard or out-of-order packet mid-frame, or an aborted read). Chip select is
+    // also deasserted after each read, allowing other SPI devices to share the bus.
+    void setStreamingEnabled(bool enabled); // def:disabled
+    bool getStreamingEnabled();
+    uint32_t getStreamingSyncedFrames(); // Consecutive frames read without needing a resync
+
+    // Sets the VoSPI packet transport to use in place of the default blocking SPI transport
+    // (see LeptonFLiRTransport.h), and must be called before init(). Transports that complete
+    // packet reads asynchronously (e.g. DMA driven) get an extra packet buffer allocated, and
+    // have the next packet read overlapped with processing of the current one. Passing NULL
+    // reverts to the default transport. Transport instance must outlive this instance.
+    void setTransport(LeptonFLiRTransport *transport);
+    LeptonFLiRTransport *getTransport();
+
+    // Sets a caller provided memory arena to carve image, packet, and telemetry data storage
+    // out of in place of heap allocation, and must be called before init(). Telemetry data
+    // storage is reserved up front, so that no heap use occurs after startup (including
+    // when telemetry is enabled or disabled). Arena must be 16 byte aligned (or have 15
+    // bytes to spare), and outlive this instance. Storage that does not fit is left
+    // unallocated, same as when allocation fails. Arena bytes needed are given by
+    // getMemoryArenaBytes(), which is constexpr in C++11 for sizing a static buffer, e.g.
+    // static byte arena[LeptonFLiR::getMemoryArenaBytes(LeptonFLiR_ImageStorageMode_40x30_8bpp)].
+    void setMemoryArena(byte *arena, int arenaBytes);
+    byte *getMemoryArena();
+    static LEPFLIR_CONSTEXPR int getMemoryArenaBytes(LeptonFLiR_ImageStorageMode storageMode, int frameBufferCount = 1, bool imageRowCallback = false, bool asyncTransport = false, bool softAGC = false, bool shadowCache = false) {
+        return arenaRoundUp16(frameBufferCount * 164) + arenaRoundUp16(imageRowCallback ? arenaImagePitch(storageMode) :
+            ((frameBufferCount - 1) * arenaRoundUp16(arenaImageTotalBytes(storageMode))) + arenaImageTotalBytes(storageMode)) +
+            arenaRoundUp16(((asyncTransport ? 2 : 1) * arenaRoundUp16(164)) + arenaRoundUp16(arenaSumBytes(storageMode)) +
+            (storageMode >= LeptonFLiR_ImageStorageMode_L3_160x120_16bpp ? arenaRoundUp16(arenaSumBytes(storageMode) + (imageRowCallback ? arenaImagePitch(storageMode) : 0)) : 0)) +
+            (softAGC ? 768 : 0) + (shadowCache ? arenaRoundUp16(sizeof(LeptonConfigProfile)) : 0);
+    }
+
+    // Packet CRC validation checks the CRC-16 carried by each VoSPI image and telemetry
+    // packet, treating packets that fail as discard packets (i.e. causing a resync) so that
+    // corrupted rows never make it into image data. Error counters allow link quality to be
+    // judged (e.g. marginal wiring or too high of a SPI speed).
+    void setPacketCRCEnabled(bool enabled); // def:disabled
+    bool getPacketCRCEnabled();
+    uint16_t getFrameCRCErrors(); // CRC errors encountered during last frame read
+    uint32_t getTotalCRCErrors(); // CRC errors encountered since init (or since reset)
+    void resetCRCErrors();
+
+    // Unique frames only skips frames whose telemetry frame counter matches that of the
+    // last frame read (the module only produces a new frame every third VoSPI frame). The
+    // counter is checked as soon as telemetry row A arrives, so only applies with telemetry
+    // enabled in the header location. Packets of duplicate frames are still read, but image
+    // rows are not written out (nor passed to the image row callback), after which the
+    // next frame is read in its place.
+    void setUniqueFramesOnly(bool enabled); // def:disabled
+    bool getUniqueFramesOnly();
+    uint32_t getDuplicateFramesSkipped(); // Duplicate frames skipped since init
+
+    // Frame statistics are accumulated from each image row as it is written out during
+    // frame read (including in image row callback mode), while still hot in cache, so
+    // that finding e.g. the hotspot does not take another pass over the frame. Values
+    // are in image data units (i.e. after downscaling and 8bpp conversion). Statistics
+    // are kept per frame buffer, alongside image data (see getFrameBufferCount).
+    void setFrameStatsEnabled(bool enabled, uint16_t threshold = 0xFFFF); // def:disabled
+    bool getFrameStatsEnabled();
+    void getFrameStats(FrameStats *stats); // Statistics of latest complete frame
+
+    // Software AGC builds a histogram of 14bpp image data as it is read, from which an 8-bit
+    // mapping LUT is made at the end of each frame read, either linear (between histogram
+    // min and max) or histogram equalized (HEQ). Histogram region and HEQ clip limits work
+    // as with the module's AGC (see agc_setHistogramRegion and agc_setHEQClipLimitHigh/Low),
+    // in module pixels, with clip limits scaled down to the image storage mode's pixel
+    // count. Only applies with the module's AGC disabled. 8bpp storage modes are mapped
+    // through the LUT of the previous frame in place of dividing 14bpp data down, while
+    // 16bpp storage modes keep 14bpp (or 16-bit TLinear) data, for which the LUT of the
+    // latest frame gives display-ready values (see getSoftAGCValue). Histogram bins span
+    // the previous frame's histogram range. Must first be enabled before init(), which
+    // allocates its storage, after which it may be disabled and re-enabled at any time.
+    // Histograms may include rows of discarded Lepton 3.x segments.
+    void setSoftAGCEnabled(bool enabled); // def:disabled
+    bool getSoftAGCEnabled();
+    void setSoftAGCPolicy(LEP_AGC_POLICY policy); // def:LEP_AGC_HEQ
+    LEP_AGC_POLICY getSoftAGCPolicy();
+    void setSoftAGCHistogramRegion(LEP_AGC_HISTOGRAM_ROI *region); // min:0,0/end>beg, max:159,119/beg<end def:{0,0,159,119} (pixels, Lepton 2.x clamped to 79,59)
+    void getSoftAGCHistogramRegion(LEP_AGC_HISTOGRAM_ROI *region);
+    void setSoftAGCHEQClipLimits(uint16_t limitHigh, uint16_t limitLow); // min:0,0 max:4800,1024 def:4800,512 (pixels, Lepton 3.x max:19200,4096)
+    byte *getSoftAGCLUT(); // 256 entry 8-bit LUT, indexed by histogram bin
+    byte getSoftAGCValue(uint16_t value); // 14bpp image data value to 8-bit display value
+
+    // Palette expansion maps image data through a 256 entry color palette into RGB565 or
+    // RGB888 color data, a row at a time into a caller provided buffer (e.g. for pushing
+    // straight out to SPI TFT displays). Palettes are made into caller provided storage of
+    // getPaletteBytes(format) bytes, either from the module's pseudo color LUTs (see
+    // vid_setPseudoColorLUT), built in as gradient stops kept in program memory, or from a
+    // user LUT (see vid_setUserColorLUT), with LEP_VID_USER_LUT and no user LUT giving
+    // grayscale. 16bpp image data is mapped down to 8-bit first (see getSoftAGCValue).
+    static int getColorBpp(LeptonFLiR_ColorFormat format); // Bytes per pixel
+    static int getPaletteBytes(LeptonFLiR_ColorFormat format);
+    static void makePalette(LEP_VID_PCOLOR_LUT table, LeptonFLiR_ColorFormat format, byte *paletteData, LEP_VID_LUT_BUFFER *userTable = NULL);
+    void colorizeRow(byte *rowData, byte *paletteData, LeptonFLiR_ColorFormat format, byte *colorData); // rowData from getImageDataRow or image row callback
+    void colorizeImage(byte *paletteData, LeptonFLiR_ColorFormat format, byte *colorData, int colorPitch);
+
+    // Scaled BLIT resizes image data to any destination resolution, using fixed-point
+    // stepping across image data with pixel centers aligned. Destination rows are made one
+    // at a time, so that displays may be filled in strips without a full destination buffer.
+    // Destination data is in image data units (of image bpp), unless given a palette (see
+    // makePalette), in which case it is expanded to color data of the palette's format.
+    void scaleImageRow(int destRow, byte *destData, int destWidth, int destHeight, LeptonFLiR_ScaleFilter filter = LeptonFLiR_ScaleFilter_Nearest, byte *paletteData = NULL, LeptonFLiR_ColorFormat format = LeptonFLiR_ColorFormat_RGB565);
+    void scaleImage(byte *destData, int destWidth, int destHeight, int destPitch, LeptonFLiR_ScaleFilter filter = LeptonFLiR_ScaleFilter_Nearest, byte *paletteData = NULL, LeptonFLiR_ColorFormat format = LeptonFLiR_ColorFormat_RGB565);
+
     // This method reads the next image frame, taking up considerable processor time.
     // Returns a boolean indicating if next frame was successfully retrieved or not.
     bool readNextFrame();
 
+    // Incremental frame reading, for when processor time is needed elsewhere during frame
+    // reads. beginFrame() starts a frame read (returning false if capture state could not be
+    // retrieved, or if one is already in progress), after which pollFrame() advances it by up
+    // to maxPackets packet reads per call (0 reads as many as possible). Resync delays do not
+    // block, with pollFrame() returning in progress until they have passed. Calls should be
+    // made often enough to read each frame within its frame period (~37ms), otherwise sync
+    // is lost and the frame read restarted. Once frame ready or failed is returned the frame
+    // read is over, as with readNextFrame().
+    bool beginFrame();
+    LeptonFLiR_FrameStatus pollFrame(int maxPackets = 0);
+
+    // Command queue, for issuing i2c commands without blocking on the module while it
+    // processes them (e.g. FFC runs, or frame averaging changes). queueCommand() appends a
+    // caller owned request (returning false if it is already queued), after which each
+    // pollCommandQueue() call advances the front request by a single step (one status
+    // check, command write, or data read), returning if any requests remain. Once done, the
+    // request's status, i2cError, and lepResult are set and its completeFunc called. Blocking
+    // command methods issued in the meantime first finish any request that is in progress.
+    bool queueCommand(CommandRequest *request);
+    bool pollCommandQueue();
+
+    // Runs an array of requests back to back, blocking until all are done, for bulk
+    // configuration (e.g. in setup). Since the module is known to be ready after each
+    // command finishes, only the first command waits on the module to begin, and short
+    // data is written together with its length. Each request's status, i2cError, and
+    // lepResult are set (with completeFunc called) as it finishes, with later requests
+    // still run after earlier ones fail. Returns the number of failed requests.
+    int runCommandBatch(CommandRequest *requests, int count);
+
+    // Camera state relevant to frame capture (AGC enable, HEQ scale factor, telemetry
+    // enable and location, boot status) is cached rather than re-queried over i2c on every
+    // frame read. The cache is filled on first frame read, kept up to date by the related
+    // agc/sys setters, and refilled after a frame read aborts. This method forces a re-read,
+    // for when the camera may have been reconfigured elsewhere (e.g. after a power cycle).
+    // Returns a boolean indicating if capture state was successfully retrieved or not.
+    bool refreshCaptureState();
+
+    // Presets cached capture state in place of reading it from the camera, for capturing
+    // frames with no module on the i2c bus (e.g. through LeptonFLiRSimulatedTransport).
+    // Should be called after init. A frame read abort or refreshCaptureState re-reads it.
+    void setCaptureState(bool agcEnabled, LEP_AGC_HEQ_SCALE_FACTOR heqScaleFactor, bool telemetryEnabled, LEP_SYS_TELEMETRY_LOCATION telemetryLocation = LEP_TELEMETRY_LOCATION_FOOTER);
+
     // AGC module commands
 
     void agc_setAGCEnabled(bool enabled); // def:disabled
@@ -243,6 +573,19 @@ public:
     void vid_setFreezeEnabled(bool enabled); // def:disabled
     bool vid_getFreezeEnabled();
 
+    // RAD module commands (radiometric modules only, e.g. Lepton 2.5/3.5)
+
+    void rad_setRadiometryEnabled(bool enabled); // def:enabled
+    bool rad_getRadiometryEnabled();
+
+    // With TLinear enabled, 16bpp image data is 16-bit scene temperature in kelvin x 100 (or
+    // x 10, see rad_setTLinearResolution), for use with the image data temperature conversions.
+    void rad_setTLinearEnabled(bool enabled); // def:enabled
+    bool rad_getTLinearEnabled();
+
+    void rad_setTLinearResolution(LEP_RAD_TLINEAR_RESOLUTION resolution); // def:LEP_RAD_RESOLUTION_0_01
+    LEP_RAD_TLINEAR_RESOLUTION rad_getTLinearResolution();
+
 #ifndef LEPFLIR_EXCLUDE_EXT_I2C_FUNCS
 
     // AGC extended module commands
@@ -337,6 +680,17 @@ public:
     void vid_setGamma(uint32_t gamma); // def:58
     uint32_t vid_getGamma();
 
+    // RAD extended module commands
+
+    void rad_setSpotmeterRegion(LEP_RAD_ROI *region); // min:0,0/end>=beg, max:59,79/beg<=end def:{29,39,30,40} (pixels, rows first)
+    void rad_getSpotmeterRegion(LEP_RAD_ROI *region);
+
+    void rad_getSpotmeterValue(LEP_RAD_SPOTMETER_OBJ_KELVIN *value); // (kelvin x 100, or x 10 as per TLinear resolution)
+    float rad_getSpotmeterTemperature(); // Spotmeter mean, in selected temperature mode
+
+    void rad_setFluxLinearParams(LEP_RAD_FLUX_LINEAR_PARAMS *params); // see LEP_RAD_FLUX_LINEAR_PARAMS for defs
+    void rad_getFluxLinearParams(LEP_RAD_FLUX_LINEAR_PARAMS *params);
+
 #endif
 
     // Module represents temperatures as kelvin x 100 (in integer format). These methods
@@ -345,14 +699,99 @@ public:
     uint16_t temperatureToKelvin100(float temperature);
     const char *getTemperatureSymbol();
 
+    // Integer temperatures are in hundredths of a degree (centi-degrees) of the selected
+    // temperature mode, avoiding floating point math. Batch conversions resolve the
+    // temperature mode once per call into a fixed-point linear mapping (exact for celsius
+    // and kelvin, within one centi-degree for fahrenheit). Image data conversions only
+    // apply to 16bpp storage modes with TLinear enabled (see rad_setTLinearEnabled), using
+    // the TLinear resolution last set or gotten.
+    int32_t kelvin100ToTemperature100(uint16_t kelvin100);
+    uint16_t temperature100ToKelvin100(int32_t temperature100);
+    void kelvin100ToTemperature100(uint16_t *kelvin100Data, int32_t *temperature100Data, int count);
+    void imageRowToTemperature100(byte *rowData, int32_t *temperature100Data); // rowData from getImageDataRow or image row callback
+    void imageToTemperature100(int32_t *temperature100Data); // image width x height values
+
     byte getLastI2CError();
     LEP_RESULT getLastLepResult();
 
+    // Shadow cache keeps a copy of the module's settable attributes (e.g. AGC policy, video
+    // polarity, telemetry location), so that getters answer from it instead of doing a full
+    // I2C command round trip, with setters writing through to it. Before answering from it,
+    // and at most once per check interval, the module's command count (see LEP_SYS_CAM_STATUS)
+    // is checked against the commands issued by this instance, invalidating the cache if
+    // some other host (or a module reset) has since issued commands. Storage (a
+    // LeptonConfigProfile, sizeof(LeptonConfigProfile) bytes) is allocated on the heap, or
+    // with a memory arena (see setMemoryArena) is carved out of the arena by init(), in which
+    // case it must first be enabled before init(), after which it may be disabled and
+    // re-enabled at any time.
+    void setShadowCacheEnabled(bool enabled, uint16_t checkInterval = 1000); // def:disabled, checkInterval in ms (0: every cached read)
+    bool getShadowCacheEnabled();
+    bool validateShadowCache(); // Checks command count now, returns false if cache was invalidated
+    void invalidateShadowCache();
+
+    // Configuration profiles hold the module's settable attributes (see LeptonConfigProfile),
+    // for restoring a known configuration after a module reboot. captureConfigProfile()
+    // reads every attribute in one batch, leaving out any the module rejects (e.g. RAD
+    // attributes on non-radiometric modules), returning the number of fields captured.
+    // diffConfigProfile() compares a profile's fields against the module, returning the
+    // number of fields that differ (optionally setting a bit per differing field).
+    // applyConfigProfile() sets a profile's fields, by default only those that differ,
+    // returning the number of fields that failed to be set. Profiles serialize to a compact
+    // checksummed blob (e.g. for EEPROM) of at most LEPFLIR_CONFIG_PROFILE_MAX_BYTES bytes,
+    // holding only the fields in use. Deserialize returns false if the blob is invalid.
+    int captureConfigProfile(LeptonConfigProfile *profile);
+    int diffConfigProfile(LeptonConfigProfile *profile, byte *diffFields = NULL); // diffFields of LEPFLIR_CONFIG_PROFILE_FIELDS bits
+    int applyConfigProfile(LeptonConfigProfile *profile, bool changedOnly = true);
+    static int serializeConfigProfile(LeptonConfigProfile *profile, byte *data, int maxBytes); // Returns bytes written, or 0 if too small
+    static bool deserializeConfigProfile(byte *data, int dataBytes, LeptonConfigProfile *profile);
+
+    // Blocking commands poll the module's busy status starting at the initial interval,
+    // doubling the interval after each busy read up to the max interval, past which the
+    // processor is yielded (or delayed 1ms) between reads. Most commands finish well under
+    // a millisecond, so tight initial polling avoids rounding each one up to the next
+    // millisecond. An initial interval at or above the max interval always yields. Command
+    // latency (from waiting to begin, to module finish) is tracked to aid in tuning.
+    void setCommandPollInterval(uint16_t initialMicros, uint16_t maxMicros = 1000); // def:25us/1000us
+    void getCommandStats(CommandStats *stats);
+    void resetCommandStats();
+
 #ifdef LEPFLIR_ENABLE_DEBUG_OUTPUT
     void printModuleInfo();
     void checkForErrors();
 #endif
 
+protected:
+    // Memory arena sizing, mirroring image storage mode geometry (in storage mode order) and
+    // the allocations made by init() so as to be usable at compile time
+    static LEPFLIR_CONSTEXPR int arenaRoundUp16(int val) {
+#ifndef LEPFLIR_DISABLE_ALIGNED_MALLOC
+        return (val + 15) & -16;
+#else
+        return val;
+#endif
+    }
+    static LEPFLIR_CONSTEXPR int arenaImageWidth(int storageMode) { return (storageMode >= 6 ? 160 : 80) >> ((storageMode % 6) / 2); }
+    static LEPFLIR_CONSTEXPR int arenaImageBpp(int storageMode) { return storageMode & 1 ? 1 : 2; }
+    static LEPFLIR_CONSTEXPR int arenaImagePitch(int storageMode) { return arenaRoundUp16(arenaImageWidth(storageMode) * arenaImageBpp(storageMode)); }
+    static LEPFLIR_CONSTEXPR int arenaImageTotalBytes(int storageMode) {
+        return (((arenaImageWidth(storageMode) * 3 / 4) - 1) * arenaImagePitch(storageMode)) + (arenaImageWidth(storageMode) * arenaImageBpp(storageMode));
+    }
+    static LEPFLIR_CONSTEXPR int arenaSumBytes(int storageMode) {
+        return (storageMode % 6) / 2 == 0 ? 0 : arenaImageWidth(storageMode) * 4;
+    }
+
+    byte *_imageBuffers[3];     // Image data of each frame buffer (aligned)
+    byte _frameBufferCount;     // Number of image/telemetry frame buffers
+    volatile byte _frontBuffer; // Frame buffer index of latest complete frame
+    bool _isReadingNextFrame;   // Tracks if next frame is being read
+    CommandRequest *_cmdQueueHead; // Command queue front (request being processed)
+    CommandRequest *_cmdQueueTail; // Command queue back
+    unsigned long _cmdQueueEndTime; // Command queue front request timeout (ms)
+    uint16_t _cmdPollMinMicros; // Command busy polling initial interval (us)
+    uint16_t _cmdPollMaxMicros; // Command busy polling max interval (us)
+    unsigned long _cmdBeginMicros; // Blocking command begin time (us)
+    CommandStats _cmdStats;     // Blocking command latency stats
+
 private:
 #ifndef LEPFLIR_USE_SOFTWARE_I2C
     TwoWire *_i2cWire;          // Wire class instance to use
@@ -364,23 +803,145 @@ private:
     digitalWriteFunc _csEnableFunc; // Chip select enable function
     digitalWriteFunc _csDisableFunc; // Chip select disable function
     byte *_imageData;           // Image data (column major)
+    byte *_imageRowData;        // Image row data (row callback mode)
+    byte *_memoryArena;         // Memory arena to carve data storage out of (NULL for heap)
+    int _memoryArenaBytes;      // Memory arena size
+    imageRowFunc _imageRowFunc; // Image row callback
+    telemetryPacketFunc _telemetryPacketFunc; // Telemetry packet callback
+    byte _backBuffer;           // Frame buffer index of frame being read
+    uint32_t _frameNumbers[3];  // Frame number of each frame buffer
+    uint32_t _framesRead;       // Frames successfully read since init
     byte *_spiFrameData;        // SPI frame data
+    LeptonFLiRTransport *_transport; // VoSPI packet transport
     byte *_telemetryData;       // SPI telemetry frame data
-    bool _isReadingNextFrame;   // Tracks if next frame is being read
+    bool _captureStateValid;    // Tracks if cached capture state is valid
+    bool _agcEnabled;           // Cached AGC enable state
+    LEP_AGC_HEQ_SCALE_FACTOR _heqScaleFactor; // Cached AGC HEQ scale factor
+    bool _telemetryEnabled;     // Cached telemetry enable state
+    LEP_SYS_TELEMETRY_LOCATION _telemetryLocation; // Cached telemetry location
+    LEP_RAD_TLINEAR_RESOLUTION _tlinearResolution; // Cached TLinear resolution (not part of capture state)
+    LeptonConfigProfile *_shadowCache; // Shadow cache attribute data
+    bool _shadowCacheEnabled;   // Shadow cache enable
+    uint16_t _shadowCacheInterval; // Shadow cache check interval (ms)
+    unsigned long _shadowCacheMillis; // Shadow cache last check time (ms)
+    uint16_t _commandCount;     // Commands issued, to compare with module command count
+    bool _commandCountValid;    // Tracks if command count is in step with module
+    bool _streamingEnabled;     // Streaming mode enable
+    bool _streamInSync;         // Tracks if VoSPI sync carried over from last frame read
+    uint32_t _streamSyncedFrames; // Consecutive frames read without a resync
+    bool _packetCRCEnabled;     // Packet CRC validation enable
+    uint16_t _frameCRCErrors;   // CRC errors during last frame read
+    uint32_t _totalCRCErrors;   // CRC errors since init/reset
+    bool _uniqueFramesOnly;     // Unique frames only enable
+    bool _lastFrameCounterValid; // Tracks if last frame counter is known
+    uint32_t _lastFrameCounter; // Telemetry frame counter of last frame read
+    uint32_t _duplicateFramesSkipped; // Duplicate frames skipped since init
+    bool _frameStatsEnabled;    // Frame statistics enable
+    uint16_t _frameStatsThreshold; // Frame statistics threshold pixel value
+    FrameStats _frameStats[3];  // Frame statistics of each frame buffer
+    byte *_softAGCData;         // Software AGC histogram and LUT (aligned)
+    bool _softAGCEnabled;       // Software AGC enable
+    LEP_AGC_POLICY _softAGCPolicy; // Software AGC policy
+    LEP_AGC_HISTOGRAM_ROI _softAGCRegion; // Software AGC histogram region (module pixels)
+    uint16_t _softAGCClipLimitHigh; // Software AGC HEQ clip limit high (module pixels)
+    uint16_t _softAGCClipLimitLow; // Software AGC HEQ clip limit low (module pixels)
+    uint16_t _softAGCHistMin;   // Value of first histogram bin
+    byte _softAGCHistShift;     // Values per histogram bin, as shift
+    uint16_t _softAGCLutMin;    // Value of first LUT entry
+    byte _softAGCLutShift;      // Values per LUT entry, as shift
     byte _lastI2CError;         // Last i2c error
     byte _lastLepResult;        // Last lep result
 
-    byte *_getImageDataRow(int row);
+    enum FrameReadPhase {
+        FrameReadPhase_Resync,  // Waiting out chip select deassert for resync
+        FrameReadPhase_Packet,  // Reading and processing packets
+        FrameReadPhase_Retry    // Reading packets until sync has been reestablished
+    };
+
+    typedef void(*downscalePacketFunc)(byte *, byte *, uint16_t *, uint_fast8_t, uint_fast8_t, uint16_t); // Passes image row data, column sums, packet data, packet row, shift, and clamp in
+
+    struct FrameReadState {
+        FrameReadPhase phase;
+        FrameReadPhase resyncPhase;
+        unsigned long waitEndTime;
+        uint16_t *spiFrame;
+        bool agc8Enabled;
+        LEP_SYS_TELEMETRY_LOCATION telemetryLocation;
+        bool lepton3;
+        uint_fast8_t imgRows, imgBpp, currImgRow;
+        uint_fast8_t spiHalves, spiScale, spiRows, currSpiRow;
+        uint_fast8_t spiSlots, currSpiSlot;
+        uint_fast8_t teleRows, currTeleRow, currReadRow, currRow;
+        uint_fast8_t framesSkipped, duplicatesSkipped, triesLeft;
+        uint32_t frameCounter;
+        bool resynced, skipFrame, waitingForFrame, duplicateFrame;
+        bool spiPacketRead, spiPacketPending, pipelined, packetCRCEnabled, imagePacketRead;
+        uint_fast16_t imgPackets, framePackets, segPacketBase;
+        uint_fast8_t segPackets, currSegment, segmentsSkipped;
+        uint_fast8_t segImgRow, segSpiRow, segTeleRow;
+        bool statsEnabled;
+        FrameStats stats, segStats;
+        bool softAGC;
+        uint_fast8_t agcRowBegin, agcRowEnd, agcColBegin, agcColEnd;
+        uint16_t agcMin, agcMax;
+        byte *sumData;
+        uint_fast8_t pxlHalfBytes, sumHalfBytes;
+        downscalePacketFunc downscaleFunc;
+        uint_fast8_t downscaleShift;
+        uint16_t clamp;
+    } _frameRead;               // Frame read state, kept between pollFrame() calls
+
+    // Kelvin x 100 to centi-degrees, as ((kelvin100 * mult + round) >> shift) + offset
+    struct TemperatureMapping {
+        uint32_t mult;
+        byte shift;
+        int32_t offset;
+    };
 
+    byte *_getImageDataRow(int row);
+    byte *getImageBuffer(int buffer);
+    int getImageBuffersTotalBytes();
+    byte *getTelemetryBuffer(int buffer);
+    byte *allocTelemetryData();
+    void freeTelemetryData();
+    void swapFrameBuffers();
+    void resetSoftAGCHistogram();
+    void softAGCPacket(uint16_t *valueData, byte *pxlData, uint_fast8_t imgCol, uint_fast8_t imgCols);
+    void updateSoftAGCLUT();
+    void writeScaledPixels(uint16_t *valueData, int count, byte *paletteData, LeptonFLiR_ColorFormat format, byte *destData);
+    void getTemperatureMapping(TemperatureMapping *mapping, byte rawScale = 1);
+    void mapTemperature100(uint16_t *rawData, int32_t *temperature100Data, int count, TemperatureMapping *mapping);
+
+    bool isLepton3StorageMode();
     int getSPIFrameLines();
+    int getSPIFrameSlots();
+    int getSPIFrameSumBytes();
+    int getSPIFrameCarryBytes();
     int getSPIFrameTotalBytes();
     uint16_t *getSPIFrameDataRow(int row);
-
+    byte *getSPIFrameSumData();
+    byte *getSPIFrameCarryData();
+    void saveSPIFrameSegment();
+    void restoreSPIFrameSegment();
+    void abortFrame();
+
+    void finishQueuedCommand();
+    void completeQueuedCommand();
+    void completeCommandRequest(CommandRequest *request);
+    void updateCommandState(CommandRequest *request);
+    void waitCommandPoll(uint16_t *pollMicros);
+    void recordCommandStats(bool timedOut);
     bool waitCommandBegin(int timeout = 0);
     bool waitCommandFinish(int timeout = 0);
 
     uint16_t cmdCode(uint16_t cmdID, uint16_t cmdType);
 
+    static int findConfigProfileField(uint16_t cmdCode);
+    bool runBatchCommand(CommandRequest *request, bool moduleReady);
+    bool readConfigProfileField(int field, uint16_t *dataWords, bool *moduleReady);
+    bool readShadowCache(uint16_t cmdCode, uint16_t *readWords, int maxLength);
+    void writeShadowCache(uint16_t cmdCode, uint16_t *dataWords, int dataLength);
+
     void sendCommand(uint16_t cmdCode);
     void sendCommand(uint16_t cmdCode, uint16_t value);
     void sendCommand(uint16_t cmdCode, uint32_t value);
@@ -390,10 +951,11 @@ private:
     void receiveCommand(uint16_t cmdCode, uint32_t *value);
     void receiveCommand(uint16_t cmdCode, uint16_t *readWords, int maxLength);
 
-    int writeCmdRegister(uint16_t cmdCode, uint16_t *dataWords, int dataLength);
+    int writeCmdRegister(uint16_t cmdCode, uint16_t *dataWords, int dataLength, bool packLength = false);
     int readDataRegister(uint16_t *readWords, int maxLength);
 
     int writeRegister(uint16_t regAddress, uint16_t value);
+    int countCommand(int i2cError);
     int readRegister(uint16_t regAddress, uint16_t *value);
 
 #ifdef LEPFLIR_USE_SOFTWARE_I2C
@@ -408,6 +970,82 @@ private:
     uint16_t i2cWire_read16(void);
 };
 
+#if __cplusplus >= 201103L
+
+// Storage mode matching a given image geometry, or LeptonFLiR_ImageStorageMode_Count if none
+constexpr LeptonFLiR_ImageStorageMode imageStorageModeFor(int width, int height, int bpp, bool lepton3) {
+    return (bpp != 1 && bpp != 2) || height * 4 != width * 3 ? LeptonFLiR_ImageStorageMode_Count :
+        !lepton3 ? (width == 80 ? (bpp == 2 ? LeptonFLiR_ImageStorageMode_80x60_16bpp : LeptonFLiR_ImageStorageMode_80x60_8bpp) :
+                    width == 40 ? (bpp == 2 ? LeptonFLiR_ImageStorageMode_40x30_16bpp : LeptonFLiR_ImageStorageMode_40x30_8bpp) :
+                    width == 20 ? (bpp == 2 ? LeptonFLiR_ImageStorageMode_20x15_16bpp : LeptonFLiR_ImageStorageMode_20x15_8bpp) :
+                    LeptonFLiR_ImageStorageMode_Count) :
+                   (width == 160 ? (bpp == 2 ? LeptonFLiR_ImageStorageMode_L3_160x120_16bpp : LeptonFLiR_ImageStorageMode_L3_160x120_8bpp) :
+                    width == 80 ? (bpp == 2 ? LeptonFLiR_ImageStorageMode_L3_80x60_16bpp : LeptonFLiR_ImageStorageMode_L3_80x60_8bpp) :
+                    width == 40 ? (bpp == 2 ? LeptonFLiR_ImageStorageMode_L3_40x30_16bpp : LeptonFLiR_ImageStorageMode_L3_40x30_8bpp) :
+                    LeptonFLiR_ImageStorageMode_Count);
+}
+
+// Variant of LeptonFLiR with image storage mode fixed at compile time (e.g. LeptonFLiRT<40, 30, 1>
+// for 40x30 8bpp, LeptonFLiRT<80, 60, 2, true> for Lepton 3.x 80x60 16bpp), for use in place of
+// LeptonFLiR with init() taking only the temperature mode. Image descriptors are constexpr and
+// image data accessors are inlined against them, so pixel by pixel image access does not need
+// to look up storage mode geometry on every call. Frame reads already resolve geometry once per
+// frame, and are shared with the runtime storage mode class.
+template <int Width, int Height, int Bpp, bool Lepton3 = (Width == 160)>
+class LeptonFLiRT : public LeptonFLiR {
+    static_assert(imageStorageModeFor(Width, Height, Bpp, Lepton3) != LeptonFLiR_ImageStorageMode_Count,
+        "LeptonFLiRT image geometry does not match any image storage mode");
+
+public:
+#ifndef LEPFLIR_USE_SOFTWARE_I2C
+    LeptonFLiRT(TwoWire& i2cWire = Wire, byte spiCSPin = 53) : LeptonFLiR(i2cWire, spiCSPin) { }
+#else
+    LeptonFLiRT(byte spiCSPin = 53) : LeptonFLiR(spiCSPin) { }
+#endif
+
+    // Called in setup()
+    void init(LeptonFLiR_TemperatureMode tempMode = LeptonFLiR_TemperatureMode_Celsius) {
+        LeptonFLiR::init(getImageStorageMode(), tempMode);
+    }
+
+    static constexpr LeptonFLiR_ImageStorageMode getImageStorageMode() { return imageStorageModeFor(Width, Height, Bpp, Lepton3); }
+
+    // Image descriptors
+    static constexpr int getImageWidth() { return Width; }
+    static constexpr int getImageHeight() { return Height; }
+    static constexpr int getImageBpp() { return Bpp; }
+#ifndef LEPFLIR_DISABLE_ALIGNED_MALLOC
+    static constexpr int getImagePitch() { return ((Width * Bpp) + 15) & -16; }
+#else
+    static constexpr int getImagePitch() { return Width * Bpp; }
+#endif
+    static constexpr int getImageTotalBytes() { return ((Height - 1) * getImagePitch()) + (Width * Bpp); }
+
+    // Memory arena bytes needed by this image storage mode (see setMemoryArena), e.g.
+    // static byte arena[LeptonFLiRT<40, 30, 1>::getMemoryArenaBytes()];
+    static constexpr int getMemoryArenaBytes(int frameBufferCount = 1, bool imageRowCallback = false, bool asyncTransport = false, bool softAGC = false, bool shadowCache = false) {
+        return LeptonFLiR::getMemoryArenaBytes(getImageStorageMode(), frameBufferCount, imageRowCallback, asyncTransport, softAGC, shadowCache);
+    }
+
+    // Image data access (disabled during frame read, unless multiple frame buffers are used)
+    using LeptonFLiR::getImageData;
+    byte *getImageData() {
+        return !(_isReadingNextFrame && _frameBufferCount == 1) ? _imageBuffers[_frontBuffer] : NULL;
+    }
+    byte *getImageDataRow(int row) {
+        byte *imageData = getImageData();
+        return imageData ? imageData + (row * getImagePitch()) : NULL;
+    }
+    uint16_t getImageDataRowCol(int row, int col) {
+        byte *imageData = getImageData();
+        if (!imageData) return 0;
+        imageData += (row * getImagePitch()) + (col * Bpp);
+        return Bpp == 2 ? *((uint16_t *)imageData) : (uint16_t)(*imageData);
+    }
+};
+
+#endif
+
 extern void wordsToHexString(uint16_t *dataWords, int dataLength, char *buffer, int maxLength);
 
 extern float kelvin100ToCelsius(uint16_t kelvin100);
@@ -416,5 +1054,9 @@ extern float kelvin100ToKelvin(uint16_t kelvin100);
 extern uint16_t celsiusToKelvin100(float celsius);
 extern uint16_t fahrenheitToKelvin100(float fahrenheit);
 extern uint16_t kelvinToKelvin100(float kelvin);
+extern int32_t kelvin100ToCelsius100(uint16_t kelvin100);
+extern int32_t kelvin100ToFahrenheit100(uint16_t kelvin100);
+extern uint16_t celsius100ToKelvin100(int32_t celsius100);
+extern uint16_t fahrenheit100ToKelvin100(int32_t fahrenheit100);
 
 #endif
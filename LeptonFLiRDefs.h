@@ -88,6 +88,7 @@
 #define LEP_I2C_COMMAND_MODULE_ID_BIT_MASK      (uint16_t)0x0F00
 #define LEP_I2C_COMMAND_ID_BIT_MASK             (uint16_t)0x00FC
 #define LEP_I2C_COMMAND_TYPE_BIT_MASK           (uint16_t)0x0003
+#define LEP_I2C_COMMAND_PROT_BIT_MASK           (uint16_t)0x4000
 
 #define LEP_I2C_COMMAND_TYPE_GET                (uint16_t)0x0000
 #define LEP_I2C_COMMAND_TYPE_SET                (uint16_t)0x0001
@@ -323,6 +324,44 @@ typedef struct {
     uint16_t endRow;
 } LEP_VID_FOCUS_ROI;
 
+#define LEP_RAD_MODULE_BASE                     (uint16_t)(LEP_I2C_COMMAND_PROT_BIT_MASK + 0x0E00)
+#define LEP_CID_RAD_ENABLE_STATE                (uint16_t)(LEP_RAD_MODULE_BASE + 0x0010)
+#define LEP_CID_RAD_FLUX_LINEAR_PARAMS          (uint16_t)(LEP_RAD_MODULE_BASE + 0x00BC)
+#define LEP_CID_RAD_TLINEAR_ENABLE_STATE        (uint16_t)(LEP_RAD_MODULE_BASE + 0x00C0)
+#define LEP_CID_RAD_TLINEAR_RESOLUTION          (uint16_t)(LEP_RAD_MODULE_BASE + 0x00C4)
+#define LEP_CID_RAD_SPOTMETER_ROI               (uint16_t)(LEP_RAD_MODULE_BASE + 0x00CC)
+#define LEP_CID_RAD_SPOTMETER_OBJ_KELVIN        (uint16_t)(LEP_RAD_MODULE_BASE + 0x00D0)
+
+typedef enum {
+    LEP_RAD_RESOLUTION_0_1 = 0, // kelvin x 10
+    LEP_RAD_RESOLUTION_0_01     // kelvin x 100
+} LEP_RAD_TLINEAR_RESOLUTION;
+
+typedef struct {
+    uint16_t startRow;
+    uint16_t startCol;
+    uint16_t endRow;
+    uint16_t endCol;
+} LEP_RAD_ROI;
+
+typedef struct {
+    uint16_t radSpotmeterValue;
+    uint16_t radSpotmeterMaxValue;
+    uint16_t radSpotmeterMinValue;
+    uint16_t radSpotmeterPopulation; // (pixels)
+} LEP_RAD_SPOTMETER_OBJ_KELVIN;
+
+typedef struct {
+    uint16_t sceneEmissivity;       // min:82 max:8192 def:8192 (x 1/8192)
+    uint16_t TBkgK;                 // def:29515 (kelvin x 100)
+    uint16_t tauWindow;             // min:82 max:8192 def:8192 (x 1/8192)
+    uint16_t TWindowK;              // def:29515 (kelvin x 100)
+    uint16_t tauAtm;                // min:82 max:8192 def:8192 (x 1/8192)
+    uint16_t TAtmK;                 // def:29515 (kelvin x 100)
+    uint16_t reflWindow;            // min:0 max:8192-tauWindow def:0 (x 1/8192)
+    uint16_t TReflK;                // def:29515 (kelvin x 100)
+} LEP_RAD_FLUX_LINEAR_PARAMS;
+
 
 typedef enum {
     LEP_OK = 0,     /* Camera ok */
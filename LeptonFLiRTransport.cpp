@@ -0,0 +1,288 @@
+/*  Arduino Library for the Lepton FLiR Thermal Camera Module.
+    Copyright (c) 2016 NachtRaveVL      <nachtravevl@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    This permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    Lepton-FLiR-Arduino - Version 0.9.91
+*/
+
+#include "LeptonFLiRTransport.h"
+
+#define LEPFLIR_SPI_FRAME_PACKET_SIZE           164 // 2B ID + 2B CRC + 160B for 80x1 14bpp/8bppAGC thermal image data or telemetry data
+#define LEPFLIR_SPI_FRAME_PACKET_SIZE16         82
+
+#ifndef LEPFLIR_DISABLE_SPI_BLOCK_TRANSFER
+
+// Converts big-endian words received over SPI into host order, in-place.
+static void swapBytes16(uint16_t *buffer, int count) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // Already in host order
+#elif defined(__AVR__)
+    byte *buffer8 = (byte *)buffer;
+    while (count-- > 0) {
+        byte temp = buffer8[0];
+        buffer8[0] = buffer8[1];
+        buffer8[1] = temp;
+        buffer8 += 2;
+    }
+#else
+    if (!((uintptr_t)buffer & 0x03)) {
+        uint32_t *buffer32 = (uint32_t *)buffer;
+        int count32 = count / 2;
+        while (count32-- > 0) {
+            uint32_t value = *buffer32;
+            *buffer32++ = ((value & 0x00FF00FF) << 8) | ((value >> 8) & 0x00FF00FF);
+        }
+        buffer = (uint16_t *)buffer32;
+        count &= 0x01;
+    }
+    while (count-- > 0) {
+        *buffer = (uint16_t)((*buffer << 8) | (*buffer >> 8));
+        ++buffer;
+    }
+#endif
+}
+
+#endif
+
+// CRC-16/CCITT (x^16 + x^12 + x^5 + 1) lookup table, one entry per leading byte value
+static const uint16_t _crc16Table[256] PROGMEM = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+static inline uint16_t crc16Byte(uint16_t crc, byte value) {
+    return (uint16_t)(crc << 8) ^ pgm_read_word(&_crc16Table[(byte)((crc >> 8) ^ value)]);
+}
+
+static inline uint16_t crc16Word(uint16_t crc, uint16_t value) {
+    return crc16Byte(crc16Byte(crc, (byte)(value >> 8)), (byte)value);
+}
+
+uint16_t LeptonFLiRTransport::calculatePacketCRC(const uint16_t *spiFrame) {
+    uint16_t crc = crc16Word(0x0000, spiFrame[0] & 0x0FFF);
+    crc = crc16Word(crc, 0x0000);
+
+    const uint16_t *spiData = spiFrame + 2;
+    uint_fast8_t count = LEPFLIR_SPI_FRAME_PACKET_SIZE16 - 2;
+    while (count-- > 0)
+        crc = crc16Word(crc, *spiData++);
+
+    return crc;
+}
+
+uint16_t LeptonFLiRTransport::calculateCRC(const byte *data, int dataBytes, uint16_t crc) {
+    while (dataBytes-- > 0)
+        crc = crc16Byte(crc, *data++);
+
+    return crc;
+}
+
+LeptonFLiRSPITransport::LeptonFLiRSPITransport(SPIClass& spi) {
+    _spi = &spi;
+}
+
+void LeptonFLiRSPITransport::begin(SPISettings settings) {
+    _spi->beginTransaction(settings);
+}
+
+void LeptonFLiRSPITransport::end() {
+    _spi->endTransaction();
+}
+
+void LeptonFLiRSPITransport::submitPacketRead(uint16_t *spiFrame) {
+#ifndef LEPFLIR_DISABLE_SPI_BLOCK_TRANSFER
+    _spi->transfer((void *)spiFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE);
+    swapBytes16(spiFrame, LEPFLIR_SPI_FRAME_PACKET_SIZE16);
+#else
+    uint_fast8_t count = LEPFLIR_SPI_FRAME_PACKET_SIZE16;
+    while (count-- > 0)
+        *spiFrame++ = _spi->transfer16(0x0000);
+#endif
+}
+
+bool LeptonFLiRSPITransport::isPacketReadComplete() {
+    return true;
+}
+
+LeptonFLiRSimulatedTransport::LeptonFLiRSimulatedTransport(unsigned long packetMicros, bool asynchronous) {
+    _packetMicros = packetMicros;
+    _asynchronous = asynchronous;
+    _teleRows = 0;
+    _teleLocation = LEP_TELEMETRY_LOCATION_FOOTER;
+    _discardPackets = 4;
+    _lepton3 = false;
+    _invalidSegmentInterval = 0;
+    _testPixelBase = 0x1F00;
+    _segmentCount = 0;
+    _segmentInvalid = false;
+    _frameNumber = 0;
+    _segmentNumber = 0;
+    _packetNumber = 0;
+    _readStartTime = 0;
+    _readPending = false;
+}
+
+void LeptonFLiRSimulatedTransport::setTelemetryRows(byte rows, LEP_SYS_TELEMETRY_LOCATION location) {
+    _teleRows = rows;
+    _teleLocation = location;
+}
+
+void LeptonFLiRSimulatedTransport::setDiscardPackets(int count) {
+    _discardPackets = max(count, 0);
+}
+
+void LeptonFLiRSimulatedTransport::setLepton3Enabled(bool enabled) {
+    _lepton3 = enabled;
+}
+
+void LeptonFLiRSimulatedTransport::setInvalidSegmentInterval(int interval) {
+    _invalidSegmentInterval = max(interval, 0);
+}
+
+void LeptonFLiRSimulatedTransport::setTestPixelBase(uint16_t base) {
+    _testPixelBase = base;
+}
+
+uint32_t LeptonFLiRSimulatedTransport::getFramesGenerated() {
+    return _frameNumber;
+}
+
+uint16_t LeptonFLiRSimulatedTransport::getTestPixel(uint32_t frame, int row, int col, uint16_t base) {
+    return (uint16_t)(base + (row * 8) + (col * 2) + (frame & 0xFF));
+}
+
+void LeptonFLiRSimulatedTransport::begin(SPISettings /*settings*/) {
+    _readPending = false;
+}
+
+void LeptonFLiRSimulatedTransport::end() {
+    while (_readPending && !isPacketReadComplete());
+}
+
+void LeptonFLiRSimulatedTransport::submitPacketRead(uint16_t *spiFrame) {
+    generatePacket(spiFrame);
+
+    _readStartTime = micros();
+    _readPending = true;
+
+    if (!_asynchronous)
+        while (!isPacketReadComplete());
+}
+
+bool LeptonFLiRSimulatedTransport::isPacketReadComplete() {
+    if (_readPending && micros() - _readStartTime >= _packetMicros)
+        _readPending = false;
+    return !_readPending;
+}
+
+bool LeptonFLiRSimulatedTransport::isAsynchronous() {
+    return _asynchronous;
+}
+
+void LeptonFLiRSimulatedTransport::generatePacket(uint16_t *spiFrame) {
+    int segPackets = (_lepton3 ? 60 + (_teleRows ? 1 : 0) : 60 + _teleRows);
+    int imgPackets = (_lepton3 ? 240 : 60);
+    int packetRow = _packetNumber - _discardPackets;
+    uint16_t *spiData = spiFrame + 2;
+
+    if (packetRow < 0) { // Discard packet
+        spiFrame[0] = 0x0F00;
+        for (int col = 0; col < 80; ++col)
+            spiData[col] = 0x0000;
+    }
+    else {
+        int framePacket = (_segmentNumber * segPackets) + packetRow;
+        int imgPacket = framePacket - (_teleLocation == LEP_TELEMETRY_LOCATION_HEADER ? _teleRows : 0);
+
+        spiFrame[0] = (uint16_t)packetRow;
+        if (_lepton3 && packetRow == 20)
+            spiFrame[0] |= (uint16_t)((_segmentInvalid ? 0 : _segmentNumber + 1) << 12);
+
+        if (_segmentInvalid) { // Invalid segment packet
+            for (int col = 0; col < 80; ++col)
+                spiData[col] = 0x3FFF;
+        }
+        else if (imgPacket >= 0 && imgPacket < imgPackets) { // Image packet
+            int imgRow = (_lepton3 ? imgPacket / 2 : imgPacket);
+            int imgCol = (_lepton3 ? (imgPacket % 2) * 80 : 0);
+            for (int col = 0; col < 80; ++col)
+                spiData[col] = getTestPixel(_frameNumber, imgRow, imgCol + col, _testPixelBase);
+        }
+        else { // Telemetry packet
+            bool teleRowA = (framePacket == (_teleLocation == LEP_TELEMETRY_LOCATION_HEADER ? 0 : imgPackets));
+            for (int col = 0; col < 80; ++col)
+                spiData[col] = 0x0000;
+
+            if (teleRowA) {
+                spiData[0] = 0x000E;                                    // revision
+                spiData[20] = (uint16_t)((_frameNumber / 3) >> 16);     // frame counter (increments every 3rd frame)
+                spiData[21] = (uint16_t)(_frameNumber / 3);
+            }
+        }
+    }
+    spiFrame[1] = calculatePacketCRC(spiFrame);
+
+    if (++_packetNumber >= _discardPackets + segPackets) {
+        _packetNumber = 0;
+
+        if (_segmentInvalid)
+            _segmentInvalid = false;
+        else if (!_lepton3 || ++_segmentNumber >= 4) {
+            _segmentNumber = 0;
+            ++_frameNumber;
+        }
+
+        if (_lepton3 && _invalidSegmentInterval && ++_segmentCount % _invalidSegmentInterval == 0)
+            _segmentInvalid = true;
+    }
+}
@@ -0,0 +1,141 @@
+/*  Arduino Library for the Lepton FLiR Thermal Camera Module.
+    Copyright (c) 2016 NachtRaveVL      <nachtravevl@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    This permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    Lepton-FLiR-Arduino - Version 0.9.91
+*/
+
+#ifndef LeptonFLiRTransport_H
+#define LeptonFLiRTransport_H
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+#include <SPI.h>
+#include "LeptonFLiRDefs.h"
+
+// VoSPI packet transport used by LeptonFLiR to receive 164 byte packets from the module.
+// A packet read is submitted into a caller supplied buffer and then polled for completion,
+// with received words converted into host order. Blocking implementations simply complete
+// the read before returning from submitPacketRead(). Asynchronous implementations (e.g. DMA
+// driven) may return early, in which case LeptonFLiR double buffers packet reception so that
+// parsing and downscaling of the current packet overlaps with reception of the next one.
+class LeptonFLiRTransport {
+public:
+    virtual ~LeptonFLiRTransport() { }
+
+    // Called at the start and end of each frame read, around chip select handling.
+    virtual void begin(SPISettings settings) = 0;
+    virtual void end() = 0;
+
+    // Begins reading the next packet into spiFrame (82 words, 4 byte aligned). Only one
+    // packet read is ever outstanding at a time.
+    virtual void submitPacketRead(uint16_t *spiFrame) = 0;
+
+    // Returns a boolean indicating if the submitted packet read has completed.
+    virtual bool isPacketReadComplete() = 0;
+
+    // Returns a boolean indicating if packet reads may complete after submitPacketRead()
+    // returns, requiring an additional packet buffer to be allocated for double buffering.
+    virtual bool isAsynchronous() { return false; }
+
+    // Calculates the CRC-16/CCITT of a received packet (in host order), which should match
+    // the packet's second word. Per VoSPI, the ID's upper 4 bits and the CRC word are taken
+    // as zero during calculation.
+    static uint16_t calculatePacketCRC(const uint16_t *spiFrame);
+
+    // Calculates the same CRC-16/CCITT (poly 0x1021) over a byte buffer, continuing on
+    // from the given CRC (e.g. for checksumming serialized data).
+    static uint16_t calculateCRC(const byte *data, int dataBytes, uint16_t crc = 0x0000);
+};
+
+// Default transport, performing blocking packet reads on a hardware SPI instance.
+class LeptonFLiRSPITransport : public LeptonFLiRTransport {
+public:
+    // May use a different SPI instance than SPI, on chipsets that have more than one.
+    LeptonFLiRSPITransport(SPIClass& spi = SPI);
+
+    virtual void begin(SPISettings settings);
+    virtual void end();
+    virtual void submitPacketRead(uint16_t *spiFrame);
+    virtual bool isPacketReadComplete();
+
+private:
+    SPIClass *_spi;             // SPI class instance to use
+};
+
+// Simulated transport, generating a synthetic VoSPI packet stream without any hardware
+// attached (e.g. when built on a host machine against an Arduino API shim). Packet reads
+// complete after the given transfer time has elapsed (~66us per packet at 20MHz), either
+// blocking or asynchronously, allowing the gain from overlapped packet processing to be
+// benchmarked. Frames are separated by discard packets and carry a known test pattern.
+class LeptonFLiRSimulatedTransport : public LeptonFLiRTransport {
+public:
+    LeptonFLiRSimulatedTransport(unsigned long packetMicros = 66, bool asynchronous = true);
+
+    // Should match the camera's telemetry setup (see sys_setTelemetryEnabled).
+    void setTelemetryRows(byte rows, LEP_SYS_TELEMETRY_LOCATION location = LEP_TELEMETRY_LOCATION_FOOTER); // def:0
+    void setDiscardPackets(int count); // def:4, packets between frames (or segments)
+
+    // Lepton 3.x mode sends 160x120 frames as four segments of packets, with the segment
+    // number carried in packet 20. Invalid segments (segment number 0) may be interspersed.
+    void setLepton3Enabled(bool enabled); // def:disabled
+    void setInvalidSegmentInterval(int interval); // def:0, every Nth segment sent is invalid
+
+    // Base value of the test pattern, e.g. 29500 for TLinear-like data (kelvin x 100).
+    void setTestPixelBase(uint16_t base); // def:0x1F00
+
+    uint32_t getFramesGenerated();
+
+    // Test pattern value generated for a given frame number and pixel position.
+    static uint16_t getTestPixel(uint32_t frame, int row, int col, uint16_t base = 0x1F00);
+
+    virtual void begin(SPISettings settings);
+    virtual void end();
+    virtual void submitPacketRead(uint16_t *spiFrame);
+    virtual bool isPacketReadComplete();
+    virtual bool isAsynchronous();
+
+private:
+    unsigned long _packetMicros; // Simulated transfer time per packet
+    bool _asynchronous;         // Asynchronous completion mode
+    byte _teleRows;             // Telemetry rows per frame
+    LEP_SYS_TELEMETRY_LOCATION _teleLocation; // Telemetry location
+    int _discardPackets;        // Discard packets between frames
+    bool _lepton3;              // Lepton 3.x segmented mode
+    int _invalidSegmentInterval; // Invalid segment interval
+    uint16_t _testPixelBase;    // Test pattern base value
+    uint32_t _segmentCount;     // Segments sent (including invalid)
+    bool _segmentInvalid;       // Tracks if current segment is invalid
+    uint32_t _frameNumber;      // Current frame number
+    int _segmentNumber;         // Current segment within frame
+    int _packetNumber;          // Position within current frame/segment (including leading discards)
+    unsigned long _readStartTime; // Time of last packet read submission
+    bool _readPending;          // Tracks if a packet read is outstanding
+
+    void generatePacket(uint16_t *spiFrame);
+};
+
+#endif
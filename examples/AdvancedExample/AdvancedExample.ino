@@ -28,28 +28,20 @@ void setup() {
     flirController.setFastCSFuncs(fastEnableCS, fastDisableCS);
 
     flirController.setSysTelemetryEnabled(ENABLED); // Ensure telemetry is enabled
+
+    flirController.setFrameStatsEnabled(ENABLED); // Gather frame statistics during frame read
 }
 
 void loop() {
     if (flirController.readNextFrame()) { // Read next frame and store result into internal imageData
-        // Find the hottest spot on the frame
-        int hotVal = 0; hotX, hotY;
-
-        for (int y = 0; y < flirController.getImageHeight(); ++y) {
-            for (int x = 0; x < flirController.getImageWidth(); ++x) {
-                int val = flirController.getImageDataRowCol(y, x);
-
-                if (val > hotVal) {
-                    hotVal = val;
-                    hotX = x; hotY = y;
-                }
-            }
-        }
+        // Find the hottest spot on the frame, already located during frame read
+        FrameStats frameStats;
+        flirController.getFrameStats(&frameStats);
 
         Serial.print("Hottest point: [");
-        Serial.print(hotX);
+        Serial.print(frameStats.maxCol);
         Serial.print(",");
-        Serial.print(hotY);
+        Serial.print(frameStats.maxRow);
         Serial.println("]");
     }
 }
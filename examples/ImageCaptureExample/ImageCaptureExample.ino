@@ -12,6 +12,9 @@ LeptonFLiR flirController(Wire, flirCSPin); // Library using Wire and chip selec
 
 const byte cardCSPin = 24;
 
+byte palette[256 * 3];                  // Color palette, in BMP file's blue-green-red byte order
+byte bmpRow[80 * 3];                    // Single BMP file row of color data
+
 void setup() {
     Serial.begin(115200);
 
@@ -29,6 +32,9 @@ void setup() {
 
     flirController.setSysTelemetryEnabled(ENABLED); // Ensure telemetry is enabled
 
+    // Using the fusion false color palette, expanded a row at a time into BMP file rows
+    LeptonFLiR::makePalette(LEP_VID_FUSION_LUT, LeptonFLiR_ColorFormat_BGR888, palette);
+
     SD.rmdir("FLIR");                   // Starting fresh with new frame captures
 }
 
@@ -49,10 +55,8 @@ void loop() {
 
             if (bmpFile) {
                 writeBMPFile(bmpFile,
-                             flirController.getImageData(),
                              flirController.getImageWidth(),
-                             flirController.getImageHeight(),
-                             flirController.getImagePitch());
+                             flirController.getImageHeight());
 
                 bmpFile.close();
 
@@ -68,7 +72,7 @@ void loop() {
 }
 
 // Writes a BMP file out, code from: http://stackoverflow.com/questions/2654480/writing-bmp-image-in-pure-c-c-without-other-libraries
-void writeBMPFile(File &bmpFile, byte *imageData, int width, int height, int pitch) {
+void writeBMPFile(File &bmpFile, int width, int height) {
     byte file[14] = {
         'B','M', // magic
         0,0,0,0, // size in bytes
@@ -115,17 +119,11 @@ void writeBMPFile(File &bmpFile, byte *imageData, int width, int height, int pit
     bmpFile.write((byte *)info, sizeof(info));
 
     byte pad[3] = {0,0,0};
-    imageData += (height - 1) * pitch;
 
     for (int y = height - 1; y >= 0; --y) {
-        for (int x = 0; x < width; ++x) {
-            byte pixel[3]; // blue green red
-            pixel[0] = pixel[1] = pixel[2] = imageData[x];
-
-            bmpFile.write((byte *)pixel, 3);
-        }
+        flirController.colorizeRow(flirController.getImageDataRow(y), palette, LeptonFLiR_ColorFormat_BGR888, bmpRow);
 
+        bmpFile.write((byte *)bmpRow, width * 3);
         bmpFile.write((byte *)pad, padSize);
-        imageData -= pitch;
     }
 }
@@ -0,0 +1,64 @@
+// Lepton-FLiR-Arduino TLinear Downscale Test
+// In this example, we will check that downscaled 16bpp storage modes keep the full 16-bit
+// range of TLinear image data (scene temperature in kelvin x 100), by feeding frames from
+// the simulated transport with pixels near 30000 (~22C) and comparing the converted
+// temperatures against the expected averages. No FLiR module is needed, as capture state
+// is preset rather than read from the camera over i2c.
+
+#include "LeptonFLiR.h"
+
+LeptonFLiRSimulatedTransport simTransport(66, false); // Blocking packet reads, ~66us per packet
+
+const uint16_t testPixelBase = 29500;   // 22.0C in kelvin x 100, at 0.01 TLinear resolution
+
+int32_t temperatureRow[40];             // Single image row of temperature data (celsius x 100)
+
+void setup() {
+    Serial.begin(115200);
+
+    simTransport.setTestPixelBase(testPixelBase);
+
+    testMode(LeptonFLiR_ImageStorageMode_40x30_16bpp, 2); // 2x2 downscale
+    testMode(LeptonFLiR_ImageStorageMode_20x15_16bpp, 4); // 4x4 downscale
+}
+
+void loop() {
+}
+
+void testMode(LeptonFLiR_ImageStorageMode storageMode, int scale) {
+    LeptonFLiR flirController;          // Library instance per mode, freeing its image data once done
+
+    flirController.setTransport(&simTransport); // Frames come from the simulated transport
+    flirController.init(storageMode, LeptonFLiR_TemperatureMode_Celsius);
+    flirController.setCaptureState(false, LEP_AGC_SCALE_TO_8_BITS, false); // AGC and telemetry disabled
+    flirController.setStreamingEnabled(true);
+
+    if (!flirController.readNextFrame()) {
+        Serial.println("FAIL: No frame read");
+        return;
+    }
+
+    uint32_t frame = simTransport.getFramesGenerated() - 1;
+    int width = flirController.getImageWidth();
+    int height = flirController.getImageHeight();
+    int failures = 0;
+
+    for (int row = 0; row < height; ++row) {
+        flirController.imageRowToTemperature100(flirController.getImageDataRow(row), temperatureRow);
+
+        for (int col = 0; col < width; ++col) {
+            uint32_t sum = 0;
+            for (int y = 0; y < scale; ++y)
+                for (int x = 0; x < scale; ++x)
+                    sum += LeptonFLiRSimulatedTransport::getTestPixel(frame, row * scale + y, col * scale + x, testPixelBase);
+
+            int32_t expected = (int32_t)(sum / (scale * scale)) - 27315;
+            if (temperatureRow[col] != expected)
+                ++failures;
+        }
+    }
+
+    Serial.print(failures ? "FAIL: " : "PASS: ");
+    Serial.print(width); Serial.print("x"); Serial.print(height);
+    Serial.print(" mode, "); Serial.print(failures); Serial.println(" mismatched pixels");
+}